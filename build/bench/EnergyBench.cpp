@@ -0,0 +1,246 @@
+// Description:
+//      Accuracy benchmark for the DistributedEnergyResource integrator. The
+//      same four hour schedule of import, export and idle setpoints is run
+//      with control ticks from 10 ms to 60 s and with adaptive ticks that
+//      sleep until NextEvent (). The schedule ramps part way through ticks and
+//      fills the energy part way through a tick. Every run must conserve the
+//      total energy, match the first ramp exactly and end with the same
+//      energy as the 10 ms run, otherwise the benchmark fails. A one unit
+//      Fleet with the same config is run through the same schedule at the
+//      fixed ticks and must conserve energy and track the DER.
+//
+// Usage:
+// EnergyBench
+
+// INCLUDES
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include "../src/include/Clock.h"
+#include "../src/include/DistributedEnergyResource.h"
+#include "../src/include/Fleet.h"
+
+using namespace std;
+
+struct Command {
+    double time;            // (ms) since the start
+    unsigned int import_watts;
+    unsigned int export_watts;
+};
+
+struct Result {
+    double first_import_energy;   // at the end of the first command
+    double import_energy;
+    double export_energy;
+    double worst_total;           // largest error of import + export energy
+    unsigned long long ticks;
+};
+
+// Unit
+// - the [DER] properties used by every run
+static map <string, string> Unit () {
+    map <string, string> init;
+    init["normal_mean"] = "0.5";
+    init["standard_deviation"] = "0.2";
+    init["rated_export_power"] = "8000";
+    init["rated_export_energy"] = "30000";
+    init["rated_export_ramp"] = "100";
+    init["rated_import_power"] = "8000";
+    init["rated_import_energy"] = "30000";
+    init["rated_import_ramp"] = "100";
+    init["idle_losses"] = "100";
+    init["log_inc"] = "0";
+    init["log_path"] = "/tmp/";
+    return init;
+}  // end Unit
+
+// Run
+// - step the resource through the commands with (tick) milliseconds, or by
+// - NextEvent () if (tick) is zero. A queued command is applied right away
+// - the same way the executor wakes the resource.
+static Result Run (const vector <Command>& commands, double end, double tick) {
+    VirtualClock clock (0);
+    Clock::Set (&clock);
+    DistributedEnergyResource der (Unit ());
+    der.SetImportEnergy (15000);
+    der.SetExportEnergy (15000);
+
+    Result result = {0, 0, 0, 0, 0};
+    double time = 0;
+    size_t next = 0;
+    while (true) {
+        // apply every command that is due
+        while (next < commands.size () && commands[next].time <= time) {
+            if (commands[next].import_watts > 0) {
+                der.QueueImportWatts (commands[next].import_watts);
+            } else if (commands[next].export_watts > 0) {
+                der.QueueExportWatts (commands[next].export_watts);
+            } else {
+                der.QueueImportWatts (0);
+            }
+            der.Loop (0);
+            if (next == 1) {
+                result.first_import_energy
+                    = der.GetSnapshot ().import_energy;
+            }
+            next++;
+        }
+        if (time >= end) {
+            break;
+        }
+
+        double step = tick > 0 ? tick : der.NextEvent ();
+        double stop = next < commands.size () ? commands[next].time : end;
+        float delta_time = min (step, stop - time);
+        der.Loop (delta_time);
+        time += delta_time;
+        if (stop - time < 1e-6) {
+            time = stop;    // float delta times may round short of the stop
+        }
+        clock.SetMilliseconds (time);
+        result.ticks++;
+
+        DistributedEnergyResource::Snapshot s = der.GetSnapshot ();
+        double total = abs ((double)s.import_energy + s.export_energy - 30000);
+        result.worst_total = max (result.worst_total, total);
+    }
+
+    DistributedEnergyResource::Snapshot s = der.GetSnapshot ();
+    result.import_energy = s.import_energy;
+    result.export_energy = s.export_energy;
+    Clock::Set (NULL);
+    return result;
+}  // end Run
+
+// Run Fleet
+// - step a one unit fleet through the commands with (tick) milliseconds, its
+// - energy starts at the same 15000 Wh as the resource
+static Result RunFleet (const vector <Command>& commands,
+                        double end,
+                        double tick) {
+    map <string, string> init = Unit ();
+    init["standard_deviation"] = "0.000000001";
+    Fleet fleet (init, 1);
+
+    Result result = {0, 0, 0, 0, 0};
+    double time = 0;
+    size_t next = 0;
+    while (true) {
+        while (next < commands.size () && commands[next].time <= time) {
+            if (commands[next].import_watts > 0) {
+                fleet.QueueImportWatts (0, commands[next].import_watts);
+            } else if (commands[next].export_watts > 0) {
+                fleet.QueueExportWatts (0, commands[next].export_watts);
+            } else {
+                fleet.QueueImportWatts (0, 0);
+            }
+            fleet.Loop (0);
+            if (next == 1) {
+                result.first_import_energy
+                    = fleet.GetSnapshot ().import_energy;
+            }
+            next++;
+        }
+        if (time >= end) {
+            break;
+        }
+
+        double stop = next < commands.size () ? commands[next].time : end;
+        float delta_time = min (tick, stop - time);
+        fleet.Loop (delta_time);
+        time += delta_time;
+        if (stop - time < 1e-6) {
+            time = stop;
+        }
+        result.ticks++;
+
+        Fleet::Snapshot s = fleet.GetSnapshot ();
+        double total = abs (s.import_energy + s.export_energy - 30000);
+        result.worst_total = max (result.worst_total, total);
+    }
+
+    Fleet::Snapshot s = fleet.GetSnapshot ();
+    result.import_energy = s.import_energy;
+    result.export_energy = s.export_energy;
+    return result;
+}  // end Run Fleet
+
+int main () {
+    const double minute = 60*1000;
+    vector <Command> commands = {
+        {0, 5000, 0},               // ramps for 50 s, not on a tick boundary
+        {10 * minute, 0, 8000},
+        {20 * minute, 0, 0},        // idle losses
+        {30 * minute, 8000, 0},     // becomes full part way through a tick
+        {150 * minute, 0, 3000},
+        {210 * minute, 0, 0},
+    };
+    double end = 240 * minute;
+
+    // 5000 W ramping at 100 W/s for 50 s then 550 s flat, in watt-hours
+    double first_ramp = (5000.0 / 2 * 50 + 5000.0 * 550) / 3600;
+    double first_expected = 15000 - first_ramp;
+
+    vector <double> ticks = {10, 100, 500, 1000, 5000, 10000, 30000, 60000, 0};
+    vector <Result> results;
+    for (double tick : ticks) {
+        results.push_back (Run (commands, end, tick));
+    }
+
+    // the snapshot stores float, so allow float rounding of 30000 Wh
+    const double tolerance = 0.01;
+    const Result& reference = results.front ();
+    bool pass = true;
+    cout << "[Energy Benchmark]\n" << fixed << setprecision (4)
+        << "Tick (ms)\tTicks\tFirst Ramp\tImport Wh\tExport Wh\t"
+        << "Drift Wh\tTotal Error\n";
+    for (size_t i = 0; i < ticks.size (); i++) {
+        const Result& r = results[i];
+        double first_error = abs (r.first_import_energy - first_expected);
+        double drift = abs (r.import_energy - reference.import_energy)
+                       + abs (r.export_energy - reference.export_energy);
+        bool ok = first_error < tolerance && drift < tolerance
+                  && r.worst_total < tolerance;
+        pass = pass && ok;
+        cout << (ticks[i] > 0 ? to_string ((int)ticks[i]) : "adaptive")
+            << "\t\t" << r.ticks
+            << "\t" << r.first_import_energy
+            << "\t" << r.import_energy
+            << "\t" << r.export_energy
+            << "\t" << drift
+            << "\t\t" << r.worst_total
+            << (ok ? "" : "\t[FAIL]") << "\n";
+    }
+
+    // the fleet at the fixed ticks against the resource at the same tick
+    cout << "Fleet (ms)\tTicks\tFirst Ramp\tImport Wh\tExport Wh\t"
+        << "DER Diff Wh\tTotal Error\n";
+    for (size_t i = 0; i < ticks.size (); i++) {
+        if (ticks[i] == 0) {
+            continue;
+        }
+        Result r = RunFleet (commands, end, ticks[i]);
+        double first_error = abs (r.first_import_energy - first_expected);
+        double diff = abs (r.import_energy - results[i].import_energy)
+                      + abs (r.export_energy - results[i].export_energy);
+        bool ok = first_error < tolerance && diff < tolerance
+                  && r.worst_total < tolerance;
+        pass = pass && ok;
+        cout << (int)ticks[i]
+            << "\t\t" << r.ticks
+            << "\t" << r.first_import_energy
+            << "\t" << r.import_energy
+            << "\t" << r.export_energy
+            << "\t" << diff
+            << "\t\t" << r.worst_total
+            << (ok ? "" : "\t[FAIL]") << "\n";
+    }
+    cout << "expected first ramp import energy " << first_expected << "\n"
+        << (pass ? "energy conserved at every tick size, fleet tracks the DER"
+                 : "[ERROR]: energy differs between tick sizes or the fleet")
+        << endl;
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}  // end main
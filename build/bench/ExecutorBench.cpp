@@ -0,0 +1,71 @@
+// Description:
+//      Timing benchmark for the Executor. Three tasks run at the control loop
+//      period for a few seconds, one of them overruns every tenth run, and the
+//      start jitter, execution time and skipped deadlines of every task are
+//      printed. A task that drifts (runs more or less often than its period
+//      allows) fails the benchmark.
+//
+// Usage:
+// ExecutorBench [<period ms> <seconds>]
+
+// INCLUDES
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include "../src/include/Executor.h"
+
+using namespace std;
+
+int main (int argc, char** argv) {
+    unsigned int period = 50, seconds = 3;
+    if (argc == 3) {
+        period = stoul (argv[1]);
+        seconds = stoul (argv[2]);
+    }
+
+    Executor executor;
+    unsigned long long fast = 0, slow = 0, work = 0;
+    double simulated = 0;
+    executor.Every ("fast", period, [&] (float delta_time) {
+        simulated += delta_time;
+        fast++;
+    });
+    executor.Every ("slow", period * 2, [&] (float delta_time) {
+        (void)delta_time;
+        // every tenth run takes longer than three periods
+        if (++slow % 10 == 0) {
+            this_thread::sleep_for (chrono::milliseconds (period * 3));
+        }
+    });
+    executor.Every ("work", period, [&] (float delta_time) {
+        (void)delta_time;
+        volatile double sum = 0;
+        for (unsigned int i = 0; i < 100000; i++) {
+            sum = sum + sqrt (i);
+        }
+        work++;
+    });
+
+    auto start = chrono::steady_clock::now ();
+    thread exec (&Executor::Run, &executor);
+    this_thread::sleep_for (chrono::seconds (seconds));
+    auto stop = chrono::steady_clock::now ();
+    executor.Stop ();
+    exec.join ();
+    chrono::duration <double, milli> join = chrono::steady_clock::now () - stop;
+    chrono::duration <double, milli> elapsed = stop - start;
+
+    cout << "[Executor Benchmark]\n";
+    executor.Display ();
+    double expected = elapsed.count () / period;
+    cout << fast << "\tfast runs (" << expected << " expected)\n"
+        << simulated << "\tms passed to the fast task ("
+        << elapsed.count () << " ms elapsed)\n"
+        << join.count () << "\tms to stop\n";
+
+    // the overruns of the slow task delay the others, but they must catch up
+    bool drift = abs (fast - expected) > 0.05 * expected + 2;
+    return drift ? EXIT_FAILURE : EXIT_SUCCESS;
+}  // end main
@@ -0,0 +1,76 @@
+// Description:
+//      Benchmark for the Fleet step kernel. Reports resources stepped per
+//      second for fleets of 1k, 10k and 100k units. The [DER] section of the
+//      config file passed with (-c) is used for every unit, otherwise the
+//      values from data/config.ini are used.
+
+// INCLUDES
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <map>
+#include "../src/include/Fleet.h"
+#include "../src/include/tsu.h"
+
+using namespace std;
+
+// Default Unit
+// - matches the [DER] section of data/config.ini
+static map <string, string> DefaultUnit () {
+    map <string, string> init;
+    init["normal_mean"] = "0.5";
+    init["standard_deviation"] = "0.2";
+    init["rated_export_power"] = "8000";
+    init["rated_export_energy"] = "30000";
+    init["rated_export_ramp"] = "100";
+    init["rated_import_power"] = "8000";
+    init["rated_import_energy"] = "30000";
+    init["rated_import_ramp"] = "100";
+    init["idle_losses"] = "100";
+    return init;
+}  // end Default Unit
+
+// Run
+// - step (units) resources for at least one second of wall time with a third
+// - of the fleet importing, a third exporting and a third idle
+static void Run (map <string, string>& init, unsigned int units) {
+    Fleet fleet (init, units);
+    for (unsigned int i = 0; i < units; i++) {
+        if (i % 3 == 0) {
+            fleet.SetImportWatts (i, 4000);
+        } else if (i % 3 == 1) {
+            fleet.SetExportWatts (i, 4000);
+        }
+    }
+
+    unsigned long ticks = 0;
+    auto start = chrono::steady_clock::now ();
+    chrono::duration <double> elapsed (0);
+    while (elapsed.count () < 1) {
+        for (unsigned int i = 0; i < 100; i++) {
+            fleet.Loop (500);
+        }
+        ticks += 100;
+        elapsed = chrono::steady_clock::now () - start;
+    }
+
+    double rate = (double)ticks * units / elapsed.count ();
+    cout << units << "\tunits\t"
+         << ticks / elapsed.count () << "\tticks/s\t"
+         << rate << "\tresources/s\n";
+}  // end Run
+
+int main (int argc, char** argv) {
+    map <string, string> init = DefaultUnit ();
+    if (argc == 3 && string (argv[1]) == "-c") {
+        tsu::config_map configs = tsu::MapConfigFile (argv[2]);
+        init = configs["DER"];
+    }
+
+    cout << "[Fleet Benchmark]\n";
+    unsigned int sizes[] = {1000, 10000, 100000};
+    for (unsigned int units : sizes) {
+        Run (init, units);
+    }
+    return 0;
+}  // end main
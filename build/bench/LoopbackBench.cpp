@@ -0,0 +1,352 @@
+// Description:
+//      End to end latency benchmark of the control path without a network.
+//      Simulated DERAS servers send ImportPower, ExportPower, price and time
+//      messages over the LoopbackTransport to a SmartGridDevice and a
+//      ServerListener, which are run by the same executor tasks as main. There
+//      are two phases:
+//
+//      load:   every server sends the four messages in turn at (rate) messages
+//              per second. Each value is unique for a while so the time it was
+//              sent is found when it shows up in the resource snapshot. A value
+//              replaced by a newer one before the resource ran is not measured.
+//      steps:  the servers send only price and time while one more server
+//              steps the import and export setpoint at a random time and waits
+//              until the device signals that the power reached it.
+//
+//      Every stage is reported in microseconds:
+//      dispatch    message sent until the transport delivered it
+//      setpoint    message sent until the setpoint is in the resource snapshot
+//      ramp        setpoint in the snapshot until the power reached it
+//      signal      power reached until the server received the property change
+//      end to end  ImportPower / ExportPower sent until the signal
+//
+// Usage:
+// LoopbackBench [<servers> <rate> <seconds> <steps> <device period (ms)>]
+
+// INCLUDES
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <map>
+#include "../src/include/DistributedEnergyResource.h"
+#include "../src/include/TelemetryPublisher.h"
+#include "../src/include/SmartGridDevice.h"
+#include "../src/include/ServerListener.h"
+#include "../src/include/LoopbackTransport.h"
+#include "../src/include/Executor.h"
+#include "../src/include/ControlTasks.h"
+#include "../src/include/Histogram.h"
+
+using namespace std;
+
+enum MessageType {IMPORT, EXPORT, PRICE, TIME, TYPES};
+static const char* type_names[TYPES] = {"import", "export", "price", "time"};
+
+// message values 1 to kValues, watts never exceed the rated power
+static const unsigned int kValues = 8000;
+static const unsigned int kBaseTime = 1500000000;
+
+struct Load {
+    atomic <bool> running;
+    atomic <bool> setpoints;        // send import and export as well
+    atomic <unsigned long long> sent;
+    atomic <unsigned long long> next[TYPES];
+    atomic <unsigned long long> sent_ns[TYPES][kValues];
+};
+
+struct Step {
+    atomic <int> type;              // TYPES while no step is active
+    atomic <unsigned int> watts;
+    atomic <unsigned long long> sent_ns;
+    atomic <unsigned long long> applied_ns;
+    atomic <unsigned long long> ramped_ns;
+    atomic <bool> done;
+};
+
+struct Stages {
+    Histogram setpoint[TYPES];
+    Histogram step_setpoint;
+    Histogram ramp;
+    Histogram signal;
+    Histogram end_to_end;
+};
+
+static Load load;
+static Step step;
+static Stages stages;   // recorded by the executor thread
+
+// Nanoseconds
+// - monotonic time stamp
+static unsigned long long Nanoseconds () {
+    return chrono::duration_cast <chrono::nanoseconds> (
+        chrono::steady_clock::now ().time_since_epoch ()).count ();
+}  // end Nanoseconds
+
+// Server
+// - a simulated DERAS server that sends (rate) messages per second until the
+// - load stops, the sent time of each value is stored before it is sent
+static void Server (LoopbackTransport* loopback_ptr,
+                    unsigned int rate,
+                    unsigned int id) {
+    chrono::nanoseconds period (1000000000ULL / rate);
+    chrono::steady_clock::time_point next = chrono::steady_clock::now ();
+    unsigned int turn = id;
+    while (load.running) {
+        int type = load.setpoints ? turn % TYPES : PRICE + turn % 2;
+        turn++;
+        unsigned long long index = load.next[type].fetch_add (1) % kValues;
+        unsigned int value = index + 1;
+        load.sent_ns[type][index] = Nanoseconds ();
+        switch (type) {
+            case IMPORT: loopback_ptr->ImportPower (value); break;
+            case EXPORT: loopback_ptr->ExportPower (value); break;
+            case PRICE: loopback_ptr->ChangePrice (value); break;
+            case TIME: loopback_ptr->ChangeTime (kBaseTime + value); break;
+        }
+        load.sent++;
+        next += period;
+        this_thread::sleep_until (next);
+    }
+}  // end Server
+
+// Record Setpoint
+// - latency from the time the value (index + 1) was sent
+static void RecordSetpoint (int type, long long index, unsigned long long now) {
+    if (index < 0 || index >= kValues) {
+        return;
+    }
+    unsigned long long sent = load.sent_ns[type][index];
+    if (sent > 0 && now > sent) {
+        stages.setpoint[type].Record (now - sent);
+    }
+}  // end Record Setpoint
+
+// Measure
+// - called by the resource task after every Loop () with the new and the last
+// - snapshot to find the setpoints that were applied and the finished ramps
+static void Measure (const DistributedEnergyResource::Snapshot& der,
+                     const DistributedEnergyResource::Snapshot& last) {
+    unsigned long long now = Nanoseconds ();
+    if (load.setpoints) {
+        if (der.import_watts != last.import_watts && der.import_watts > 0) {
+            RecordSetpoint (IMPORT, der.import_watts - 1LL, now);
+        }
+        if (der.export_watts != last.export_watts && der.export_watts > 0) {
+            RecordSetpoint (EXPORT, der.export_watts - 1LL, now);
+        }
+    }
+    if (der.price != last.price) {
+        RecordSetpoint (PRICE, lround (der.price * 10) - 1, now);
+    }
+    if (der.remote_utc != last.remote_utc) {
+        RecordSetpoint (TIME, (long long)der.remote_utc - kBaseTime - 1, now);
+    }
+
+    int type = step.type;
+    if (type == TYPES) {
+        return;
+    }
+    unsigned int watts = step.watts;
+    unsigned int setpoint = type == IMPORT ? der.import_watts : der.export_watts;
+    float power = type == IMPORT ? der.import_power : der.export_power;
+    if (step.applied_ns == 0 && setpoint == watts) {
+        step.applied_ns = now;
+        stages.step_setpoint.Record (now - step.sent_ns);
+    }
+    if (step.applied_ns > 0 && step.ramped_ns == 0 && power == watts) {
+        step.ramped_ns = now;
+        stages.ramp.Record (now - step.applied_ns);
+    }
+}  // end Measure
+
+// Signal
+// - the server side of the properties changed signal, it finishes the step
+// - once the power property reports the setpoint
+static void Signal (const char** props,
+                    const unsigned int* values,
+                    size_t count) {
+    int type = step.type;
+    if (type == TYPES || step.ramped_ns == 0) {
+        return;
+    }
+    const char* name = type == IMPORT ? "import_power" : "export_power";
+    for (size_t i = 0; i < count; i++) {
+        if (!strcmp (props[i], name) && values[i] == step.watts) {
+            unsigned long long now = Nanoseconds ();
+            stages.signal.Record (now - step.ramped_ns);
+            stages.end_to_end.Record (now - step.sent_ns);
+            step.type = TYPES;
+            step.done = true;
+            return;
+        }
+    }
+}  // end Signal
+
+// Print Stage
+// - one row of percentiles in microseconds
+static void PrintStage (const string& name, const Histogram& histogram) {
+    cout << setw (20) << name
+        << setw (10) << histogram.Count ()
+        << setw (12) << histogram.Percentile (0.5) / 1000.0
+        << setw (12) << histogram.Percentile (0.99) / 1000.0
+        << setw (12) << histogram.Percentile (0.999) / 1000.0
+        << histogram.Max () / 1000.0 << "\n";
+}  // end Print Stage
+
+int main (int argc, char** argv) {
+    unsigned int servers = 4, rate = 1000, seconds = 5, steps = 20;
+    unsigned int period = 100;
+    unsigned int* args[] = {&servers, &rate, &seconds, &steps, &period};
+    for (int i = 1; i < argc && i <= 5; i++) {
+        *args[i - 1] = stoul (argv[i]);
+    }
+
+    // the ramp is fast enough for a step to finish in well under a second
+    map <string, string> init;
+    init["normal_mean"] = "0.5";
+    init["standard_deviation"] = "0.2";
+    init["rated_export_power"] = to_string (kValues);
+    init["rated_export_energy"] = "30000";
+    init["rated_export_ramp"] = "20000";
+    init["rated_import_power"] = to_string (kValues);
+    init["rated_import_energy"] = "30000";
+    init["rated_import_ramp"] = "20000";
+    init["idle_losses"] = "100";
+    init["log_inc"] = "0";
+    init["log_path"] = "/tmp/";
+    DistributedEnergyResource der (init);
+    der.SetImportEnergy (15000);
+    der.SetExportEnergy (15000);
+    der.Loop (0);
+
+    // no deadbands or interval so every change is signaled
+    map <string, string> telemetry;
+    telemetry["min_interval"] = "0";
+    TelemetryPublisher publisher (telemetry);
+
+    // the same tasks as main, commands wake the resource before any can arrive
+    Executor executor;
+    control_tasks::WakeOnCommand (&executor, &der);
+
+    LoopbackTransport loopback;
+    SmartGridDevice sgd (&der, &publisher, &loopback);
+    ServerListener listener (&der, &loopback, false);
+    atomic <unsigned long long> signals (0);
+    loopback.SetPropertiesListener ([&signals] (const char** props,
+                                                const unsigned int* values,
+                                                size_t count) {
+        signals++;
+        Signal (props, values, count);
+    });
+
+    DistributedEnergyResource::Snapshot last = der.GetSnapshot ();
+    control_tasks::AddResource (&executor, &der, &publisher, period, 60000,
+        [&last] (const DistributedEnergyResource::Snapshot& snapshot) {
+            Measure (snapshot, last);
+            last = snapshot;
+        });
+    control_tasks::AddDevice (&executor, &sgd, period);
+
+    step.type = TYPES;
+    load.running = true;
+    load.setpoints = true;
+    thread dispatch (&LoopbackTransport::Run, &loopback);
+    thread exec (&Executor::Run, &executor);
+    vector <thread> threads;
+    for (unsigned int i = 0; i < servers; i++) {
+        threads.push_back (thread (Server, &loopback, rate, i));
+    }
+
+    // load phase
+    unsigned long long start_sent = load.sent;
+    unsigned long long start_delivered = loopback.GetDelivered ();
+    unsigned long long start_signals = signals;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now ();
+    this_thread::sleep_for (chrono::seconds (seconds));
+    chrono::duration <double> elapsed = chrono::steady_clock::now () - start;
+    double sent_rate = (load.sent - start_sent) / elapsed.count ();
+    double delivered_rate
+        = (loopback.GetDelivered () - start_delivered) / elapsed.count ();
+    double signal_rate = (signals - start_signals) / elapsed.count ();
+
+    // step phase, the last import and export of the load are applied first
+    load.setpoints = false;
+    this_thread::sleep_for (chrono::milliseconds (100));
+    unsigned int timeouts = 0;
+    for (unsigned int i = 0; i < steps; i++) {
+        // a random pause so the steps are not in phase with the device task
+        unsigned int pause = rand () % (period * 1000);
+        this_thread::sleep_for (chrono::microseconds (pause));
+        int type = i % 2 ? EXPORT : IMPORT;
+        unsigned int watts = 2000 + 1000 * ((i / 2) % 6);
+        step.done = false;
+        step.applied_ns = 0;
+        step.ramped_ns = 0;
+        step.watts = watts;
+        step.sent_ns = Nanoseconds ();
+        step.type = type;
+        if (type == IMPORT) {
+            loopback.ImportPower (watts);
+        } else {
+            loopback.ExportPower (watts);
+        }
+
+        chrono::steady_clock::time_point timeout
+            = chrono::steady_clock::now () + chrono::seconds (10);
+        while (!step.done && chrono::steady_clock::now () < timeout) {
+            this_thread::sleep_for (chrono::microseconds (100));
+        }
+        if (!step.done) {
+            step.type = TYPES;
+            timeouts++;
+        }
+    }
+
+    load.running = false;
+    for (thread& server : threads) {
+        server.join ();
+    }
+    loopback.Stop ();
+    dispatch.join ();
+    executor.Stop ();
+    exec.join ();
+
+    cout << "[Loopback Benchmark]\n"
+        << servers << " servers at " << rate << " messages/s for "
+        << seconds << " s, " << steps << " steps, device period "
+        << period << " ms\n"
+        << fixed << setprecision (1) << left
+        << setw (20) << "Stage"
+        << setw (10) << "Count"
+        << setw (12) << "p50 (us)"
+        << setw (12) << "p99 (us)"
+        << setw (12) << "p999 (us)"
+        << "max (us)\n";
+    PrintStage ("dispatch", loopback.GetLatency ());
+    for (int i = 0; i < TYPES; i++) {
+        PrintStage (string (type_names[i]) + " setpoint", stages.setpoint[i]);
+    }
+    PrintStage ("step setpoint", stages.step_setpoint);
+    PrintStage ("step ramp", stages.ramp);
+    PrintStage ("step signal", stages.signal);
+    PrintStage ("step end to end", stages.end_to_end);
+    cout << right << "\nThroughput (load phase)\n"
+        << sent_rate << "\tmessages/s sent\n"
+        << delivered_rate << "\tmessages/s delivered\n"
+        << signal_rate << "\tproperty signals/s\n\n";
+    executor.Display ();
+    publisher.Display ();
+
+    if (timeouts > 0) {
+        cout << "[ERROR]: " << timeouts << " steps were not signaled" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}  // end main
@@ -0,0 +1,189 @@
+// Description:
+//      Startup benchmark for the schedule and config parsers. A schedule with
+//      (rows) rows and a config with (units) [DER.n] sections are written to
+//      /tmp, then each file is parsed with the legacy string copying / regex
+//      implementation and with the tsu string_view tokenizer. Both results
+//      must match and the time of each is reported. The schedule time is
+//      Operator::Reload (), which parses with tsu::ParseCSV and sorts the rows.
+//
+// Usage:
+// ParseBench [<rows> <units>]
+
+// INCLUDES
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <regex>
+#include <map>
+#include <vector>
+#include <string_view>
+#include "../src/include/tsu.h"
+#include "../src/include/Operator.h"
+
+using namespace std;
+
+// Legacy Map Config File
+// - the regular expression parser that tsu::MapConfigFile replaced
+static tsu::config_map LegacyMapConfigFile (const string& kFilename) {
+    tsu::config_map file_map;
+    string file_string, line, section, property, value;
+    file_string = tsu::FileToString(kFilename);
+
+    regex section_regex("^\\[(.*)\\]");
+    regex property_regex("^(\\w+)=([^\\+]+(?!\\+{3}))");
+    smatch match_regex;
+
+    stringstream ss(file_string);
+    while (getline(ss, line)) {
+        if (regex_search(line, match_regex, section_regex)) {
+            section = match_regex[1];
+        } else if (regex_search(line, match_regex, property_regex)){
+            property = match_regex[1];
+            value = match_regex[2];
+            file_map[section][property] = value;
+        }
+    }
+    return file_map;
+}  // end Legacy Map Config File
+
+// Legacy Compile
+// - the string matrix schedule parser that Operator::Compile replaced, it
+// - returns the number of rows and a checksum of their values
+static size_t LegacyCompile (const string& kFilename, unsigned long long& sum) {
+    tsu::string_matrix matrix = tsu::FileToMatrix(kFilename, ',', 3);
+    size_t rows = 0;
+    for (unsigned int i = 0; i < matrix.size(); i++) {
+        const auto &col = matrix[i];
+        unsigned int time, setting, control;
+        try {
+            time = stoul(col[0]) % (60*60*24);
+            setting = stoul(col[2]);
+        } catch (...) {
+            continue;
+        }
+        if (col[1] == "import") {
+            control = 1;
+        } else if (col[1] == "export") {
+            control = 2;
+        } else {
+            control = 0;
+        }
+        sum += time + setting + control;
+        rows++;
+    }
+    return rows;
+}  // end Legacy Compile
+
+// Parse Schedule
+// - the schedule rows read with tsu::ParseCSV, used to check the legacy rows
+static size_t ParseSchedule (const string& kFilename,
+                             unsigned long long& sum) {
+    size_t rows = 0;
+    tsu::ParseCSV(kFilename, ',',
+        [&] (size_t line, const vector <string_view>& cells) {
+            (void)line;
+            unsigned long long utc;
+            unsigned int setting, control;
+            if (cells.size() != 3
+                || !tsu::ParseNumber(cells[0], utc)
+                || !tsu::ParseNumber(cells[2], setting)) {
+                return;
+            }
+            string_view name = tsu::Trim(cells[1]);
+            if (name == "import") {
+                control = 1;
+            } else if (name == "export") {
+                control = 2;
+            } else {
+                control = 0;
+            }
+            sum += utc % (60*60*24) + setting + control;
+            rows++;
+        }
+    );
+    return rows;
+}  // end Parse Schedule
+
+// Seconds
+// - wall time of a function call
+template <typename Function>
+static double Seconds (Function function) {
+    auto start = chrono::steady_clock::now ();
+    function ();
+    chrono::duration <double> elapsed = chrono::steady_clock::now () - start;
+    return elapsed.count ();
+}  // end Seconds
+
+int main (int argc, char** argv) {
+    size_t rows = 1000000, units = 10000;
+    if (argc == 3) {
+        rows = stoul (argv[1]);
+        units = stoul (argv[2]);
+    }
+
+    string schedule_file = "/tmp/parse_bench_schedule.csv";
+    string config_file = "/tmp/parse_bench_config.ini";
+    {
+        ofstream schedule (schedule_file);
+        const char* controls[] = {"idle", "import", "export"};
+        for (size_t i = 0; i < rows; i++) {
+            schedule << 1543447665 + i << ","
+                << controls[i % 3] << "," << (i * 37) % 8000 << "\n";
+        }
+        ofstream config (config_file);
+        config << "[Threads]\nsleep=500\n\n[Fleet]\nunits=" << units << "\n";
+        for (size_t i = 0; i < units; i++) {
+            config << "\n[DER." << i << "]\n"
+                << "# unit " << i << "\n"
+                << "rated_export_power=" << 4000 + i % 4000 << "\n"
+                << "rated_export_energy=30000\n"
+                << "rated_export_ramp=100\n"
+                << "rated_import_power=" << 4000 + i % 4000 << "\n"
+                << "rated_import_energy=30000\n"
+                << "rated_import_ramp=100\n"
+                << "idle_losses=100\n"
+                << "normal_mean=0.5\n"
+                << "standard_deviation=0.2\n";
+        }
+    }
+
+    size_t legacy_rows = 0;
+    unsigned long long legacy_sum = 0;
+    double legacy_schedule = Seconds ([&] () {
+        legacy_rows = LegacyCompile (schedule_file, legacy_sum);
+    });
+
+    Operator oper (schedule_file, NULL);
+    bool reloaded = false;
+    double new_schedule = Seconds ([&] () {
+        reloaded = oper.Reload (schedule_file);
+    });
+    unsigned long long sum = 0;
+    size_t parsed_rows = ParseSchedule (schedule_file, sum);
+
+    tsu::config_map legacy_configs, configs;
+    double legacy_config = Seconds ([&] () {
+        legacy_configs = LegacyMapConfigFile (config_file);
+    });
+    double new_config = Seconds ([&] () {
+        configs = tsu::MapConfigFile (config_file);
+    });
+
+    bool match = reloaded && legacy_rows == parsed_rows && legacy_sum == sum
+                 && legacy_configs == configs;
+    cout << "[Parse Benchmark]\n"
+        << rows << "\tschedule rows\n"
+        << legacy_schedule << "\ts legacy FileToMatrix\n"
+        << new_schedule << "\ts Operator::Reload\n"
+        << legacy_schedule / new_schedule << "\tx faster\n"
+        << units << "\tconfig sections\n"
+        << legacy_config << "\ts legacy regex\n"
+        << new_config << "\ts MapConfigFile\n"
+        << legacy_config / new_config << "\tx faster\n"
+        << (match ? "results match" : "[ERROR]: results differ") << endl;
+
+    remove (schedule_file.c_str ());
+    remove (config_file.c_str ());
+    return match ? EXIT_SUCCESS : EXIT_FAILURE;
+}  // end main
@@ -0,0 +1,105 @@
+// Description:
+//      Stress benchmark for the DistributedEnergyResource thread hand off. A
+//      control thread runs Loop () as fast as it can while writer threads
+//      queue import/export setpoints and reader threads take snapshots. Every
+//      snapshot is checked for a torn state (import and export both active)
+//      and the read and write throughput is reported. Queued setpoints are
+//      last writer wins, so the rate of applied setpoints is bounded by the
+//      ticks while writers never fail.
+//
+// Usage:
+// SnapshotBench [<readers> <writers> <seconds>]
+
+// INCLUDES
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <map>
+#include "../src/include/DistributedEnergyResource.h"
+
+using namespace std;
+
+int main (int argc, char** argv) {
+    unsigned int readers = 4, writers = 4, seconds = 3;
+    if (argc == 4) {
+        readers = stoul (argv[1]);
+        writers = stoul (argv[2]);
+        seconds = stoul (argv[3]);
+    }
+
+    map <string, string> init;
+    init["normal_mean"] = "0.5";
+    init["standard_deviation"] = "0.2";
+    init["rated_export_power"] = "8000";
+    init["rated_export_energy"] = "30000";
+    init["rated_export_ramp"] = "100";
+    init["rated_import_power"] = "8000";
+    init["rated_import_energy"] = "30000";
+    init["rated_import_ramp"] = "100";
+    init["idle_losses"] = "100";
+    init["log_inc"] = "60";
+    init["log_path"] = "/tmp/";
+    DistributedEnergyResource der (init);
+
+    atomic <bool> done (false);
+    atomic <unsigned long long> reads (0), writes (0), torn (0);
+    unsigned long long ticks = 0;
+
+    vector <thread> threads;
+    for (unsigned int i = 0; i < readers; i++) {
+        threads.emplace_back ([&] () {
+            unsigned long long count = 0, errors = 0;
+            while (!done) {
+                DistributedEnergyResource::Snapshot s = der.GetSnapshot ();
+                // SetImportWatts/SetExportWatts always zero the other side
+                if ((s.import_watts > 0 && s.export_watts > 0)
+                    || (s.import_watts > 0 && s.export_power > 0)
+                    || (s.export_watts > 0 && s.import_power > 0)) {
+                    errors++;
+                }
+                count++;
+            }
+            reads += count;
+            torn += errors;
+        });
+    }
+    for (unsigned int i = 0; i < writers; i++) {
+        threads.emplace_back ([&, i] () {
+            unsigned long long count = 0;
+            unsigned int watts = 1000 + i;
+            while (!done) {
+                if (count % 2) {
+                    der.QueueImportWatts (watts);
+                } else {
+                    der.QueueExportWatts (watts);
+                }
+                count++;
+            }
+            writes += count;
+        });
+    }
+
+    // the control thread is the main thread
+    auto start = chrono::steady_clock::now ();
+    auto end = start + chrono::seconds (seconds);
+    while (chrono::steady_clock::now () < end) {
+        der.Loop (1);
+        ticks++;
+    }
+    done = true;
+    for (auto& t : threads) {
+        t.join ();
+    }
+    chrono::duration <double> elapsed = chrono::steady_clock::now () - start;
+
+    cout << "[Snapshot Benchmark]\n"
+        << readers << "\treaders\t" << writers << "\twriters\n"
+        << ticks / elapsed.count () << "\tticks/s\n"
+        << reads / elapsed.count () << "\tsnapshots/s\n"
+        << writes / elapsed.count () << "\tcommands/s\n"
+        << torn << "\ttorn snapshots\n";
+    return torn == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}  // end main
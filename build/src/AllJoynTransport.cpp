@@ -0,0 +1,191 @@
+// INCLUDES
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include "include/AllJoynTransport.h"
+
+const char* AllJoynTransport::server_props[] = {"time", "price"};
+
+// Constructor
+// - initialize bus object interface and its method handlers
+AllJoynTransport::AllJoynTransport (ajn::BusAttachment* bus_ptr,
+                                    const char* device_interface,
+                                    const char* path,
+                                    const char* server_interface)
+                                        : ajn::BusObject(path),
+                                          bus_ptr_(bus_ptr),
+                                          device_ptr_(NULL),
+                                          server_ptr_(NULL),
+                                          interface_(device_interface),
+                                          server_interface_(server_interface) {
+    const ajn::InterfaceDescription* interface = bus_ptr_->GetInterface(interface_);
+    assert(interface != NULL);
+    AddInterface(*interface, ANNOUNCED);
+
+    const ajn::BusObject::MethodEntry methods[] = {{
+            interface->GetMember("ImportPower"), 
+            static_cast <ajn::BusObject::MessageReceiver::MethodHandler>
+            (&AllJoynTransport::ImportPowerHandler)
+        }, {
+            interface->GetMember("ExportPower"), 
+            static_cast <ajn::BusObject::MessageReceiver::MethodHandler>
+            (&AllJoynTransport::ExportPowerHandler)
+        },
+
+    };
+
+    size_t count = sizeof (methods) / sizeof (methods[0]);
+    QStatus status = AddMethodHandlers (methods, count);
+    if (ER_OK != status) {
+        throw status;
+    }
+}  // end Constructor
+
+// Set Device Handler
+// - receives the method calls, set before the bus object is registered
+void AllJoynTransport::SetDeviceHandler (DeviceHandler* handler_ptr) {
+    device_ptr_ = handler_ptr;
+}  // end Set Device Handler
+
+// Set Server Handler
+// - receives the property changes, set before the listener is registered
+void AllJoynTransport::SetServerHandler (ServerHandler* handler_ptr) {
+    server_ptr_ = handler_ptr;
+}  // end Set Server Handler
+
+// Emit Properties Changed
+// - build the PropertiesChanged signal from the values passed in, since
+// - EmitPropChanged () would read each property again with Get ()
+bool AllJoynTransport::EmitPropertiesChanged (const char** props,
+                                              const unsigned int* values,
+                                              size_t count) {
+    const ajn::InterfaceDescription* properties
+        = bus_ptr_->GetInterface("org.freedesktop.DBus.Properties");
+    if (properties == NULL) {
+        return false;
+    }
+    const ajn::InterfaceDescription::Member* member
+        = properties->GetMember("PropertiesChanged");
+    if (member == NULL) {
+        return false;
+    }
+
+    // signature "sa{sv}as", nothing is invalidated
+    std::vector <ajn::MsgArg> variants (count);
+    std::vector <ajn::MsgArg> changed (count);
+    for (size_t i = 0; i < count; i++) {
+        variants[i].Set("u", values[i]);
+        changed[i].Set("{sv}", props[i], &variants[i]);
+    }
+    ajn::MsgArg args[3];
+    args[0].Set("s", interface_);
+    args[1].Set("a{sv}", count, changed.data());
+    args[2].Set("as", 0, NULL);
+    QStatus status = Signal (NULL, ajn::SESSION_ID_ALL_HOSTED, *member,
+                             args, 3);
+    std::cout << "Sending telemetry update (" << count
+        << " properties):\t" << status << std::endl;
+    return ER_OK == status;
+}  // end Emit Properties Changed
+
+// Import Power Handler
+// - called by remote consumer and sends the watt value for import
+void AllJoynTransport::ImportPowerHandler (
+        const ajn::InterfaceDescription::Member* member,
+        ajn::Message& message) {
+    (void)member;
+    unsigned int import_watts = message->GetArg(0)->v_uint32;
+    std::cout << "[ALLJOYN]: Import...\t" << import_watts << std::endl;
+    if (device_ptr_) {
+        device_ptr_->ImportPower (import_watts);
+    }
+}  // end Import Power Handler
+
+// Export Power Handler
+// - called by remote consumer and sends the watt value for export
+void AllJoynTransport::ExportPowerHandler (
+        const ajn::InterfaceDescription::Member* member,
+        ajn::Message& message) {
+    (void)member;
+    unsigned int export_watts = message->GetArg(0)->v_uint32;
+    std::cout << "[ALLJOYN]: Export...\t" << export_watts << std::endl;
+    if (device_ptr_) {
+        device_ptr_->ExportPower (export_watts);
+    }
+}  // end Export Power Handler
+
+// Get
+// - this method will be called by remote devices looking to get this devices
+// - properties
+QStatus AllJoynTransport::Get (const char* interface,
+                               const char* property,
+                               ajn::MsgArg& value) {
+    if (strcmp(interface, interface_) || !device_ptr_) {
+        return ER_FAIL;
+    }
+
+    // MsgArg must be given an unsigned int for "u"
+    unsigned int property_value;
+    if (!device_ptr_->Get (property, property_value)) {
+        return ER_FAIL;
+    }
+    return value.Set("u", property_value);
+} // end Get
+
+// ObjectDiscovered
+// - a remote device has advertised the interface we are looking for
+void AllJoynTransport::ObjectDiscovered (ajn::ProxyBusObject& proxy) {
+    const char* name = proxy.GetUniqueName().c_str();
+    std::printf("[LISTENER] : %s has been discovered\n", name);
+    bus_ptr_->EnableConcurrentCallbacks();
+    proxy.RegisterPropertiesChangedListener(
+        server_interface_, server_props, 2, *this, NULL
+    );
+} // end ObjectDiscovered
+
+// ObjectLost
+// - the remote device is no longer available
+void AllJoynTransport::ObjectLost (ajn::ProxyBusObject& proxy) {
+    const char* name = proxy.GetUniqueName().c_str();
+    const char* path = proxy.GetPath().c_str();
+    std::printf("[LISTENER] : %s connection lost\n", name);
+    std::printf("\tPath : %s no longer exists\n", path);
+} // end ObjectLost
+
+// PropertiesChanged
+// - callback to recieve property changed event from remote bus object
+void AllJoynTransport::PropertiesChanged (ajn::ProxyBusObject& obj,
+                                          const char* interface_name,
+                                          const ajn::MsgArg& changed,
+                                          const ajn::MsgArg& invalidated,
+                                          void* context) {
+    std::cout << "DERAS: prop change" << std::endl;
+    size_t nelem = 0;
+    ajn::MsgArg* elems = NULL;
+    QStatus status = changed.Get("a{sv}", &nelem, &elems);
+    if (status == ER_OK) {
+        for (size_t i = 0; i < nelem; i++) {
+            const char* name;
+            ajn::MsgArg* val;
+            status = elems[i].Get("{sv}", &name, &val);
+            if (status == ER_OK) {
+                if (!strcmp(name,"price")) {
+                    int price;
+                    status = val->Get("i", &price);
+                    std::cout << price << std::endl;
+                    if (status == ER_OK && server_ptr_) {
+                        server_ptr_->PriceChanged (price);
+                    }
+                } else if (!strcmp(name,"time")) {
+                    unsigned int time;
+                    status = val->Get("u", &time);
+                    if (status == ER_OK && server_ptr_) {
+                        server_ptr_->TimeChanged (time);
+                    }
+                }
+            } else {
+                std::printf("[LISTENER] : invalid property change!\n");
+            }
+        }
+    }
+} // end PropertiesChanged
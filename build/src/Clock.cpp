@@ -0,0 +1,56 @@
+// INCLUDES
+#include <chrono>
+#include "include/Clock.h"
+
+// the system clock is a static object so it is valid before main () and after
+// any virtual clock installed by the program has been destroyed
+static SystemClock system_clock;
+std::atomic <Clock*> Clock::clock_ptr_(&system_clock);
+
+Clock::~Clock () {
+    // do nothing
+}  // end destructor
+
+// Now
+// - seconds since the unix epoch
+time_t Clock::Now () {
+    return Milliseconds () / 1000;
+}  // end Now
+
+// Get
+// - return the clock used by the program
+Clock* Clock::Get () {
+    return clock_ptr_.load ();
+}  // end Get
+
+// Set
+// - install a new clock for the program, NULL restores the system clock
+void Clock::Set (Clock* clock_ptr) {
+    if (clock_ptr == NULL) {
+        clock_ptr = &system_clock;
+    }
+    clock_ptr_.store (clock_ptr);
+}  // end Set
+
+// Milliseconds
+// - wall clock time
+unsigned long long SystemClock::Milliseconds () {
+    auto now = std::chrono::system_clock::now ().time_since_epoch ();
+    return std::chrono::duration_cast <std::chrono::milliseconds> (now).count ();
+}  // end Milliseconds
+
+VirtualClock::VirtualClock (unsigned long long milliseconds)
+    : milliseconds_(milliseconds) {
+}  // end constructor
+
+// Milliseconds
+// - simulated time
+unsigned long long VirtualClock::Milliseconds () {
+    return milliseconds_.load ();
+}  // end Milliseconds
+
+// Set Milliseconds
+// - move simulated time, normally only called by the EventScheduler
+void VirtualClock::SetMilliseconds (unsigned long long milliseconds) {
+    milliseconds_.store (milliseconds);
+}  // end Set Milliseconds
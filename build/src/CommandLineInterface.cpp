@@ -2,12 +2,22 @@
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <atomic>
 #include "include/CommandLineInterface.h"
+#include "include/LogWriter.h"
 
-bool scheduled;  // this variable is a global from main
+std::atomic <bool> scheduled;  // this variable is a global from main
 
 CommandLineInterface::CommandLineInterface (
-	DistributedEnergyResource* der_ptr) : der_ptr_(der_ptr) {
+	DistributedEnergyResource* der_ptr,
+	Operator* oper_ptr,
+	TelemetryPublisher* publisher_ptr,
+	Executor* executor_ptr,
+	Fleet* fleet_ptr) : der_ptr_(der_ptr),
+	                    oper_ptr_(oper_ptr),
+	                    publisher_ptr_(publisher_ptr),
+	                    executor_ptr_(executor_ptr),
+	                    fleet_ptr_(fleet_ptr) {
 }  // end constructor
 
 CommandLineInterface::~CommandLineInterface () {
@@ -21,9 +31,16 @@ void CommandLineInterface::Help () {
         << "> q            quit\n"
         << "> h            display help menu\n"
         << "> o <y/n>      operator enable/disable\n"
+        << "> r <file>     reload operator schedule\n"
         << "> i <watts>    import power\n"
         << "> e <watts>    export power\n"
-        << "> d            display properties\n";
+        << "> d            display properties\n"
+        << "> l            display logging counters\n"
+        << "> t            display telemetry counters\n"
+        << "> x            display executor task timing\n"
+        << "> f            display fleet totals\n"
+        << "> f i <watts> [unit]   fleet import power, every unit by default\n"
+        << "> f e <watts> [unit]   fleet export power, every unit by default\n";
 } // end Help
 
 // Command Line Interface
@@ -50,7 +67,7 @@ bool CommandLineInterface::Control (const std::string& input) {
 
         case 'i': {
             try {
-                der_ptr_->SetImportWatts(stoul(tokens.at(1)));
+                der_ptr_->QueueImportWatts(stoul(tokens.at(1)));
             } catch (...) {
                 std::cout << "[ERROR]: Invalid Argument.\n";
                 break;
@@ -74,9 +91,20 @@ bool CommandLineInterface::Control (const std::string& input) {
             break;
         }
 
+        case 'r': {
+            try {
+                if (oper_ptr_->Reload(tokens.at(1))) {
+                    std::cout << "Schedule reloaded...\n";
+                }
+            } catch(...) {
+                std::cout << "[ERROR]: Invalid Argument.\n";
+            }
+            break;
+        }
+
         case 'e': {
             try {
-                der_ptr_->SetExportWatts(stoul(tokens.at(1)));
+                der_ptr_->QueueExportWatts(stoul(tokens.at(1)));
             } catch(...) {
                 std::cout << "[ERROR]: Invalid Argument.\n";
             }
@@ -88,6 +116,26 @@ bool CommandLineInterface::Control (const std::string& input) {
             break;
         }
 
+        case 'l': {
+            LogWriter::Get ().Display ();
+            break;
+        }
+
+        case 't': {
+            publisher_ptr_->Display ();
+            break;
+        }
+
+        case 'x': {
+            executor_ptr_->Display ();
+            break;
+        }
+
+        case 'f': {
+            CommandLineInterface::FleetControl (tokens);
+            break;
+        }
+
         default: {
             CommandLineInterface::Help ();
             break;
@@ -95,4 +143,44 @@ bool CommandLineInterface::Control (const std::string& input) {
     }
 
     return false;
-}  // end Command Line Interface
\ No newline at end of file
+}  // end Command Line Interface
+
+// Fleet Control
+// - queue an import or export setpoint for one unit or the whole fleet, or
+// - display the fleet totals
+void CommandLineInterface::FleetControl (
+    const std::vector <std::string>& tokens) {
+    if (!fleet_ptr_) {
+        std::cout << "[ERROR]: Fleet is disabled, set [Fleet] units.\n";
+        return;
+    }
+    if (tokens.size () == 1) {
+        fleet_ptr_->Display ();
+        return;
+    }
+
+    try {
+        const std::string& control = tokens.at(1);
+        unsigned int watts = stoul(tokens.at(2));
+        unsigned int first = 0, last = fleet_ptr_->GetUnits ();
+        if (tokens.size () > 3) {
+            first = stoul(tokens.at(3));
+            last = first + 1;
+            if (first >= fleet_ptr_->GetUnits ()) {
+                throw std::out_of_range ("unit");
+            }
+        }
+        if (control != "i" && control != "e") {
+            throw std::invalid_argument ("control");
+        }
+        for (unsigned int i = first; i < last; i++) {
+            if (control == "i") {
+                fleet_ptr_->QueueImportWatts (i, watts);
+            } else {
+                fleet_ptr_->QueueExportWatts (i, watts);
+            }
+        }
+    } catch (...) {
+        std::cout << "[ERROR]: Invalid Argument.\n";
+    }
+}  // end Fleet Control
@@ -0,0 +1,62 @@
+// INCLUDES
+#include <algorithm>
+#include "include/ControlTasks.h"
+
+namespace control_tasks {
+
+// Wake On Command
+// - queued commands wake the resource task so they are applied right away,
+// - set before the CLI or a transport can queue one
+void WakeOnCommand (Executor* executor_ptr,
+                    DistributedEnergyResource* der_ptr) {
+    der_ptr->SetCommandNotify ([executor_ptr] () { executor_ptr->Wake (); });
+}  // end Wake On Command
+
+// Next Step
+// - (ms) until the next predicted event of the resource (ramp done, energy
+// - full or empty, a log or a telemetry energy deadband). The power deadbands
+// - are not predicted, so while the power ramps it is the device (period) to
+// - keep the snapshot fresh
+double NextStep (DistributedEnergyResource* der_ptr,
+                 TelemetryPublisher* publisher_ptr,
+                 unsigned int period) {
+    double margin = publisher_ptr->EnergyMargin (der_ptr->GetSnapshot ());
+    double next = std::min (der_ptr->NextEvent (),
+                            der_ptr->TimeToTransfer (margin));
+    if (der_ptr->IsRamping ()) {
+        next = std::min (next, (double)period);
+    }
+    return next;
+}  // end Next Step
+
+// Add Resource
+// - the resource sleeps until its next step, at most (max_sleep) ms
+void AddResource (Executor* executor_ptr,
+                  DistributedEnergyResource* der_ptr,
+                  TelemetryPublisher* publisher_ptr,
+                  unsigned int period,
+                  unsigned int max_sleep,
+                  SnapshotObserver observer) {
+    executor_ptr->Adaptive ("resource", 1, max_sleep,
+        [der_ptr, publisher_ptr, period, observer] (float delta_time) {
+            der_ptr->Loop (delta_time);
+            if (observer) {
+                observer (der_ptr->GetSnapshot ());
+            }
+            return NextStep (der_ptr, publisher_ptr, period);
+        }
+    );
+}  // end Add Resource
+
+// Add Device
+// - send the properties that changed every (period) ms
+void AddDevice (Executor* executor_ptr,
+                SmartGridDevice* sgd_ptr,
+                unsigned int period) {
+    executor_ptr->Every ("device", period, [sgd_ptr] (float delta_time) {
+        (void)delta_time;
+        sgd_ptr->Loop ();
+    });
+}  // end Add Device
+
+}  // end control_tasks
@@ -2,6 +2,11 @@
 #include <iostream>
 #include <random>
 #include <ctime>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include "include/Clock.h"
 #include "include/DistributedEnergyResource.h"
 #include "include/logger.h"
 
@@ -16,12 +21,18 @@ DistributedEnergyResource::DistributedEnergyResource () :
     import_ramp_(0),
     idle_losses_(0),
     export_power_(0),
+    export_energy_(0),
     import_power_(0),
+    import_energy_(0),
     export_watts_(0),
     import_watts_(0),
+    remote_utc_(0),
+    price_(0),
     delta_time_(0),
-    last_utc_(0) {
-    // do nothing
+    last_utc_(0),
+    log_inc_(0),
+    log_binary_(false) {
+    DistributedEnergyResource::Publish ();
 }  // end constructor
 
 // this constructor is used to simulate a genaric der
@@ -38,10 +49,13 @@ DistributedEnergyResource::DistributedEnergyResource (
     import_power_(0),
     export_watts_(0),
     import_watts_(0),
+    remote_utc_(0),
+    price_(0),
     delta_time_(0),
     last_utc_(0),
     log_inc_(stoul(init["log_inc"])),
-    log_path_(init["log_path"]) {
+    log_path_(init["log_path"]),
+    log_binary_(init["log_format"] == "binary") {
 
     // randomly assign energy capacity based on normal distripution
     // - reference: 
@@ -60,6 +74,7 @@ DistributedEnergyResource::DistributedEnergyResource (
     // use random percentage to set import and export where export is (1-p)
     import_energy_ = rated_import_energy_ * percent;
     export_energy_ = rated_export_energy_ * (1 - percent);
+    DistributedEnergyResource::Publish ();
 }  // end constructor
 
 DistributedEnergyResource::~DistributedEnergyResource () {
@@ -93,7 +108,7 @@ void DistributedEnergyResource::SetExportPower (float power) {
 
 // Set Export Energy
 // - regulates export energy
-void DistributedEnergyResource::SetExportEnergy (float energy) {
+void DistributedEnergyResource::SetExportEnergy (double energy) {
     if (energy > rated_export_energy_) {
         export_energy_ = rated_export_energy_;
     } else if (energy <= 0) {
@@ -147,7 +162,7 @@ void DistributedEnergyResource::SetImportPower (float power) {
 
 // Set Import Energy
 // - regulates import energy balance export energy
-void DistributedEnergyResource::SetImportEnergy (float energy) {
+void DistributedEnergyResource::SetImportEnergy (double energy) {
     if (energy > rated_import_energy_) {
         import_energy_ = rated_import_energy_;
     } else if (energy <= 0) {
@@ -319,112 +334,215 @@ void DistributedEnergyResource::SetLastUTC (unsigned int utc) {
     last_utc_ = utc;
 }  // end Set Last UTC
 
-// Import Power
-// - calculate power/energy change 
-// - degrement import energy and increment export energy
-void DistributedEnergyResource::ImportPower () {
-    // regulate import power
-    float seconds = delta_time_ / 1000;
-    float ramp_watts = import_ramp_ * seconds;
-    float power;
-    if (import_power_ == import_watts_){
-        // do nothing
-    } else if (import_power_ < import_watts_) {
-        power = import_power_ + ramp_watts;
-        if (power > import_watts_) {
-            power = import_watts_;
+// Ramp Energy
+// - move (power) towards (watts) at (ramp) watts per second for (seconds) and
+// - return the exact watt-hours under the power curve, which is linear until
+// - the setpoint is reached and then flat. A zero ramp holds the power.
+static double RampEnergy (float& power,
+                          double watts,
+                          double ramp,
+                          double seconds) {
+    double start = power;
+    double end = start;
+    double ramp_seconds = 0;
+    if (ramp > 0 && start != watts) {
+        ramp_seconds = std::abs (watts - start) / ramp;
+        if (ramp_seconds < seconds) {
+            end = watts;
+        } else {
+            ramp_seconds = seconds;
+            end = start + (watts > start ? ramp : -ramp) * seconds;
         }
-        DistributedEnergyResource::SetImportPower (power);
-    } else if (import_power_ > import_watts_) {
-        power = import_power_ - ramp_watts;
-        if (power < import_watts_) {
-            power = import_watts_;
+    }
+    power = end;
+    double watt_seconds = (start + end) / 2 * ramp_seconds
+                          + end * (seconds - ramp_seconds);
+    return watt_seconds / (60*60);
+}  // end Ramp Energy
+
+// Transfer Time
+// - seconds until (watt_hours) have moved on the same power curve as
+// - RampEnergy, infinity if the power never moves that much energy
+static double TransferTime (double power,
+                            double watts,
+                            double ramp,
+                            double watt_hours) {
+    const double never = std::numeric_limits <double>::infinity ();
+    double watt_seconds = watt_hours * 60*60;
+    if (watt_seconds <= 0) {
+        return 0;
+    }
+
+    if (ramp > 0 && power != watts) {
+        double ramp_seconds = std::abs (watts - power) / ramp;
+        double ramp_watt_seconds = (power + watts) / 2 * ramp_seconds;
+        if (watt_seconds <= ramp_watt_seconds) {
+            // solve power*t + slope*t^2/2 = watt_seconds for t
+            double slope = watts > power ? ramp : -ramp;
+            double root = std::sqrt (std::max (
+                power * power + 2 * slope * watt_seconds, 0.0));
+            return (root - power) / slope;
         }
-        DistributedEnergyResource::SetImportPower (power);
+        watt_seconds -= ramp_watt_seconds;
+        return watts > 0 ? ramp_seconds + watt_seconds / watts : never;
     }
+    return power > 0 ? watt_seconds / power : never;
+}  // end Transfer Time
 
-    // regulate energy
-    float hours = seconds / (60*60);
-    float watt_hours = 0;
-
-    // if the import power didn't reach rated then include ramp in energy calc
-    // this function does not account for the cycle where it reaches rated,
-    // but the error is negligable comparted to rated energy
-    if (import_power_ < rated_import_power_) {
-        // area under the linear function
-        watt_hours += import_power_ * hours;  // area under triangle
-        watt_hours += ramp_watts * hours/2;   // area of triangle
-        DistributedEnergyResource::SetImportEnergy(import_energy_ - watt_hours);
-        DistributedEnergyResource::SetExportEnergy(export_energy_ + watt_hours);
-    } else {
-        // area under the linear function excluding ramp.
-        // note: this will exclude some energy if it reached peak within bounds
-        watt_hours += import_power_ * hours;
-        DistributedEnergyResource::SetImportEnergy(import_energy_ - watt_hours);
-        DistributedEnergyResource::SetExportEnergy(export_energy_ + watt_hours);
+// Import Power
+// - calculate power/energy change 
+// - degrement import energy and increment export energy. If the energy
+// - becomes full part way through the tick only the energy up to full is
+// - moved and the import power stops.
+void DistributedEnergyResource::ImportPower () {
+    double seconds = delta_time_ / 1000;
+    double room = std::min (import_energy_,
+                            rated_export_energy_ - export_energy_);
+    room = std::max (room, 0.0);
+
+    float power = import_power_;
+    double watt_hours = RampEnergy (power, import_watts_, import_ramp_, seconds);
+    if (watt_hours >= room) {
+        watt_hours = room;
+        power = 0;
     }
+    DistributedEnergyResource::SetImportPower (power);
+    DistributedEnergyResource::SetImportEnergy (import_energy_ - watt_hours);
+    DistributedEnergyResource::SetExportEnergy (export_energy_ + watt_hours);
 }  // end Import Power
 
 // Export Power
 // - calculate power/energy change 
-// - degrement export energy and increment import energy
+// - degrement export energy and increment import energy. If the energy
+// - becomes empty part way through the tick only the energy that was left is
+// - moved and the export power stops.
 void DistributedEnergyResource::ExportPower () {
-    float seconds = delta_time_ / 1000;
-    float ramp_watts = export_ramp_ * seconds;
-    float power;
-    if (export_power_ == export_watts_){
-        // do nothing
-    } else if (export_power_ < export_watts_) {
-        power = export_power_ + ramp_watts;
-        if (power > export_watts_) {
-            power = export_watts_;
-        }
-        DistributedEnergyResource::SetExportPower (power);
-    } else if (export_power_ > export_watts_) {
-        power = export_power_ - ramp_watts;
-        if (power < export_watts_) {
-            power = export_watts_;
-        }
-        DistributedEnergyResource::SetExportPower (power);
-    }
-
-    // regulate energy
-    float hours = seconds / (60*60);
-    float watt_hours = 0;
-
-    // if the import power didn't reach rated then include ramp in energy calc
-    // this function does not account for the cycle where it reaches rated,
-    // but the error is negligable comparted to rated energy
-    if (export_power_ < rated_export_power_) {
-        // area under the linear function
-        watt_hours += export_power_ * hours;  // area under triangle
-        watt_hours += ramp_watts * hours/2;   // area of triangle
-        DistributedEnergyResource::SetImportEnergy(import_energy_ + watt_hours);
-        DistributedEnergyResource::SetExportEnergy(export_energy_ - watt_hours);
-    } else {
-        // area under the linear function excluding ramp.
-        // note: this will exclude some energy if it reached peak within bounds
-        watt_hours += export_power_ * hours;
-        DistributedEnergyResource::SetImportEnergy(import_energy_ + watt_hours);
-        DistributedEnergyResource::SetExportEnergy(export_energy_ - watt_hours);
+    double seconds = delta_time_ / 1000;
+    double stored = std::min (export_energy_,
+                              rated_import_energy_ - import_energy_);
+    stored = std::max (stored, 0.0);
+
+    float power = export_power_;
+    double watt_hours = RampEnergy (power, export_watts_, export_ramp_, seconds);
+    if (watt_hours >= stored) {
+        watt_hours = stored;
+        power = 0;
     }
+    DistributedEnergyResource::SetExportPower (power);
+    DistributedEnergyResource::SetImportEnergy (import_energy_ + watt_hours);
+    DistributedEnergyResource::SetExportEnergy (export_energy_ - watt_hours);
 }  // end Export Power
 
 // Idle Loss
-// - update energy available based on energy lost
+// - update energy available based on energy lost, no more than is stored
 void DistributedEnergyResource::IdleLoss () {
-    float seconds = delta_time_ / 1000;
-    float hours = seconds / (60*60);
-    float energy_loss = idle_losses_ * hours;
+    double seconds = delta_time_ / 1000;
+    double hours = seconds / (60*60);
+    double energy_loss = std::min (idle_losses_ * hours,
+                                   std::min (export_energy_,
+                                   rated_import_energy_ - import_energy_));
+    energy_loss = std::max (energy_loss, 0.0);
     DistributedEnergyResource::SetImportEnergy(import_energy_ + energy_loss);
     DistributedEnergyResource::SetExportEnergy(export_energy_ - energy_loss);
 }  // end Idle Loss
 
+// Time To Transfer
+// - milliseconds until (watt_hours) have moved at the current setpoints, by
+// - import, export or idle losses. Infinity if that never happens.
+double DistributedEnergyResource::TimeToTransfer (double watt_hours) {
+    double seconds;
+    if (import_watts_ > 0) {
+        seconds = TransferTime (import_power_, import_watts_, import_ramp_,
+                                watt_hours);
+    } else if (export_watts_ > 0) {
+        seconds = TransferTime (export_power_, export_watts_, export_ramp_,
+                                watt_hours);
+    } else {
+        // idle losses are a constant power (Wh per hour)
+        seconds = TransferTime (idle_losses_, idle_losses_, 0, watt_hours);
+    }
+    return seconds * 1000;
+}  // end Time To Transfer
+
+// Next Event
+// - milliseconds until the next change that is not linear at the current
+// - setpoints: the power reaching its setpoint, the energy becoming full or
+// - empty, or the next log. Infinity if nothing will change.
+double DistributedEnergyResource::NextEvent () {
+    double next = std::numeric_limits <double>::infinity ();
+    // the power stays off while the energy is full (import) or empty (export)
+    if (import_watts_ > 0) {
+        double room = std::min (import_energy_,
+                                rated_export_energy_ - export_energy_);
+        if (room > 0) {
+            if (import_ramp_ > 0 && import_power_ != import_watts_) {
+                next = std::abs (import_watts_ - import_power_) / import_ramp_;
+                next *= 1000;
+            }
+            next = std::min (next, TimeToTransfer (room));
+        }
+    } else if (export_watts_ > 0) {
+        double stored = std::min (export_energy_,
+                                  rated_import_energy_ - import_energy_);
+        if (stored > 0) {
+            if (export_ramp_ > 0 && export_power_ != export_watts_) {
+                next = std::abs (export_watts_ - export_power_) / export_ramp_;
+                next *= 1000;
+            }
+            next = std::min (next, TimeToTransfer (stored));
+        }
+    } else {
+        double stored = std::min (export_energy_,
+                                  rated_import_energy_ - import_energy_);
+        if (stored > 0) {
+            next = std::min (next, TimeToTransfer (stored));
+        }
+    }
+
+    if (log_inc_ > 0) {
+        unsigned long long inc = log_inc_ * 1000ULL;
+        unsigned long long now = Clock::Get ()->Milliseconds ();
+        next = std::min (next, (double)(inc - now % inc));
+    }
+    return next;
+}  // end Next Event
+
+// Is Ramping
+// - true while the power is moving toward its setpoint, the power deadbands
+// - are not predicted by NextEvent () so the caller should not sleep long
+bool DistributedEnergyResource::IsRamping () {
+    if (import_watts_ > 0) {
+        double room = std::min (import_energy_,
+                                rated_export_energy_ - export_energy_);
+        return room > 0 && import_ramp_ > 0 && import_power_ != import_watts_;
+    } else if (export_watts_ > 0) {
+        double stored = std::min (export_energy_,
+                                  rated_import_energy_ - import_energy_);
+        return stored > 0 && export_ramp_ > 0 && export_power_ != export_watts_;
+    }
+    return false;
+}  // end Is Ramping
+
 // Log
 // - log important physical attributes of DER on a frequency set by config file
+// - as either text lines or compact binary telemetry records
 void DistributedEnergyResource::Log () {
-    unsigned int utc = time (0);
-    if (utc % log_inc_ == 0 && last_utc_ != utc){
+    unsigned int utc = Clock::Get ()->Now ();
+    if (log_inc_ == 0 || utc % log_inc_ != 0 || last_utc_ == utc) {
+        return;
+    }
+
+    if (log_binary_) {
+        TelemetryRecord telemetry;
+        telemetry.utc_ms = utc * 1000ULL;
+        telemetry.import_watts = import_watts_;
+        telemetry.import_power = import_power_;
+        telemetry.import_energy = import_energy_;
+        telemetry.export_watts = export_watts_;
+        telemetry.export_power = export_power_;
+        telemetry.export_energy = export_energy_;
+        LogWriter::Get ().Push ("DER_Data", log_path_, telemetry);
+    } else {
         Logger ("DER_Data", log_path_)
             << import_watts_ << "\t"
             << import_power_ << "\t"
@@ -432,15 +550,114 @@ void DistributedEnergyResource::Log () {
             << export_watts_ << "\t"
             << export_power_ << "\t"
             << export_energy_ << "\t";
-        last_utc_ = utc;
     }
+    last_utc_ = utc;
 }  // end Log
 
+// Notify
+// - wake the control thread after a setpoint was stored
+void DistributedEnergyResource::Notify () {
+    if (notify_) {
+        notify_ ();
+    }
+}  // end Notify
+
+// Set Command Notify
+// - (notify) is called on the queueing thread after each command, for example
+// - to wake the control loop so the command is not delayed by a long sleep
+void DistributedEnergyResource::SetCommandNotify (
+    std::function <void ()> notify) {
+    notify_ = notify;
+}  // end Set Command Notify
+
+// Queue Import Watts
+// - thread safe SetImportWatts, applied by the next Loop (). It replaces an
+// - import or export command that was not applied yet.
+void DistributedEnergyResource::QueueImportWatts (unsigned int power) {
+    power_command_.Store (IMPORT, power);
+    DistributedEnergyResource::Notify ();
+}  // end Queue Import Watts
+
+// Queue Export Watts
+// - thread safe SetExportWatts, applied by the next Loop (). It replaces an
+// - import or export command that was not applied yet.
+void DistributedEnergyResource::QueueExportWatts (unsigned int power) {
+    power_command_.Store (EXPORT, power);
+    DistributedEnergyResource::Notify ();
+}  // end Queue Export Watts
+
+// Queue Price
+// - thread safe SetPrice, applied by the next Loop ()
+void DistributedEnergyResource::QueuePrice (float price) {
+    unsigned int bits;
+    std::memcpy (&bits, &price, sizeof (bits));
+    price_command_.Store (0, bits);
+    DistributedEnergyResource::Notify ();
+}  // end Queue Price
+
+// Queue Remote Time
+// - thread safe SetRemoteTime, applied by the next Loop ()
+void DistributedEnergyResource::QueueRemoteTime (unsigned int utc) {
+    time_command_.Store (0, utc);
+    DistributedEnergyResource::Notify ();
+}  // end Queue Remote Time
+
+// Apply Commands
+// - apply the latest command of each kind
+void DistributedEnergyResource::ApplyCommands () {
+    unsigned char tag;
+    unsigned int value;
+    if (power_command_.Take (tag, value)) {
+        if (tag == IMPORT) {
+            DistributedEnergyResource::SetImportWatts (value);
+        } else {
+            DistributedEnergyResource::SetExportWatts (value);
+        }
+    }
+    if (price_command_.Take (tag, value)) {
+        float price;
+        std::memcpy (&price, &value, sizeof (price));
+        DistributedEnergyResource::SetPrice (price);
+    }
+    if (time_command_.Take (tag, value)) {
+        DistributedEnergyResource::SetRemoteTime (value);
+    }
+}  // end Apply Commands
+
+// Publish
+// - store a snapshot of every property for other threads
+void DistributedEnergyResource::Publish () {
+    Snapshot snapshot;
+    snapshot.rated_export_power = rated_export_power_;
+    snapshot.rated_export_energy = rated_export_energy_;
+    snapshot.export_ramp = export_ramp_;
+    snapshot.rated_import_power = rated_import_power_;
+    snapshot.rated_import_energy = rated_import_energy_;
+    snapshot.import_ramp = import_ramp_;
+    snapshot.idle_losses = idle_losses_;
+    snapshot.export_power = export_power_;
+    snapshot.export_energy = export_energy_;
+    snapshot.import_power = import_power_;
+    snapshot.import_energy = import_energy_;
+    snapshot.export_watts = export_watts_;
+    snapshot.import_watts = import_watts_;
+    snapshot.remote_utc = remote_utc_;
+    snapshot.price = price_;
+    snapshot_.Store (snapshot);
+}  // end Publish
+
+// Get Snapshot
+// - consistent copy of the properties published by the last Loop ()
+DistributedEnergyResource::Snapshot DistributedEnergyResource::GetSnapshot () {
+    return snapshot_.Load ();
+}  // end Get Snapshot
+
 // Loop
 // - for non simulated devices the delta_time value can be ignored.
+// - the physics of the last (delta_time) use the setpoints that were active
+// - during it, then queued commands are applied and a snapshot is published.
 void DistributedEnergyResource::Loop (float delta_time) {
     delta_time_ = delta_time;
-
     if (import_watts_ > 0) {
         DistributedEnergyResource::ImportPower ();
     } else if (export_watts_ > 0) {
@@ -448,18 +665,22 @@ void DistributedEnergyResource::Loop (float delta_time) {
     } else {
         IdleLoss ();
     }
+    DistributedEnergyResource::ApplyCommands ();
     DistributedEnergyResource::Log ();
+    DistributedEnergyResource::Publish ();
 }  // end Control
 
 // Display
 // - print device properties to terminal
 void DistributedEnergyResource::Display () {
+    Snapshot snapshot = DistributedEnergyResource::GetSnapshot ();
     std::cout 
-        << "Import Power:\t" << import_power_ << "\twatts\n"
-        << "Import Control:\t" << import_watts_ << "\twatts\n"
-        << "Import Energy:\t" << import_energy_ << "\twatt-hours\n"
-        << "Export Power:\t" << export_power_ << "\twatts\n"
-        << "Export Control:\t" << export_watts_ << "\twatts\n"
-        << "Export Energy:\t" << export_energy_ << "\twatt-hours\n" 
-        << "Power Price:\t" << price_ << "\tcents/watt-hours\n" << std::endl;
+        << "Import Power:\t" << snapshot.import_power << "\twatts\n"
+        << "Import Control:\t" << snapshot.import_watts << "\twatts\n"
+        << "Import Energy:\t" << snapshot.import_energy << "\twatt-hours\n"
+        << "Export Power:\t" << snapshot.export_power << "\twatts\n"
+        << "Export Control:\t" << snapshot.export_watts << "\twatts\n"
+        << "Export Energy:\t" << snapshot.export_energy << "\twatt-hours\n" 
+        << "Power Price:\t" << snapshot.price << "\tcents/watt-hours\n" 
+        << std::endl;
 }  // end Display
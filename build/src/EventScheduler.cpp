@@ -0,0 +1,63 @@
+// INCLUDES
+#include "include/EventScheduler.h"
+
+EventScheduler::EventScheduler (VirtualClock* clock_ptr)
+    : clock_ptr_(clock_ptr), sequence_(0), event_count_(0) {
+}  // end constructor
+
+EventScheduler::~EventScheduler () {
+    // do nothing
+}  // end destructor
+
+// At
+// - schedule an event for an absolute time in milliseconds. Events in the past
+// - run at the current time.
+void EventScheduler::At (unsigned long long time,
+                         std::function <void ()> event) {
+    unsigned long long now = clock_ptr_->Milliseconds ();
+    if (time < now) {
+        time = now;
+    }
+    events_.emplace (time, sequence_++, event);
+}  // end At
+
+// Every
+// - schedule a periodic event starting at (start). The event reschedules
+// - itself after running so it only occupies one slot in the queue.
+void EventScheduler::Every (unsigned long long start,
+                            unsigned long long period,
+                            std::function <void ()> event) {
+    EventScheduler::At (start, [this, start, period, event] () {
+        event ();
+        EventScheduler::Every (start + period, period, event);
+    });
+}  // end Every
+
+// Run
+// - process events in time order until the next event is after (end) and
+// - then leave the clock at (end).
+void EventScheduler::Run (unsigned long long end) {
+    while (!events_.empty () && events_.top ().time <= end) {
+        // copy the event since the action may schedule new events
+        Event event = events_.top ();
+        events_.pop ();
+        clock_ptr_->SetMilliseconds (event.time);
+        event.action ();
+        event_count_++;
+    }
+    if (clock_ptr_->Milliseconds () < end) {
+        clock_ptr_->SetMilliseconds (end);
+    }
+}  // end Run
+
+// Get Event Count
+// - number of events processed by Run ()
+unsigned long long EventScheduler::GetEventCount () {
+    return event_count_;
+}  // end Get Event Count
+
+// Get Time
+// - current simulated time in milliseconds
+unsigned long long EventScheduler::GetTime () {
+    return clock_ptr_->Milliseconds ();
+}  // end Get Time
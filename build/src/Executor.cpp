@@ -0,0 +1,191 @@
+// INCLUDES
+#include <iostream>
+#include <iomanip>
+#include "include/Executor.h"
+
+Executor::Executor () : stop_(false), woken_(false) {
+}  // end constructor
+
+Executor::~Executor () {
+    // do nothing
+}  // end destructor
+
+// Every
+// - register a task that runs every (period) milliseconds, the first run is as
+// - soon as Run () starts and is passed zero. Tasks must be registered before
+// - Run ().
+void Executor::Every (const std::string& name,
+                      unsigned int period,
+                      Function function) {
+    std::unique_ptr <Task> task_ptr (new Task);
+    task_ptr->name = name;
+    task_ptr->period = std::chrono::milliseconds (period);
+    task_ptr->minimum = task_ptr->period;
+    task_ptr->function = function;
+    task_ptr->overruns = 0;
+    tasks_.push_back (std::move (task_ptr));
+}  // end Every
+
+// Adaptive
+// - register a task that returns how many milliseconds until it should run
+// - again, limited to [minimum, maximum]. The first run is as soon as Run ()
+// - starts. Tasks must be registered before Run ().
+void Executor::Adaptive (const std::string& name,
+                         unsigned int minimum,
+                         unsigned int maximum,
+                         AdaptiveFunction function) {
+    std::unique_ptr <Task> task_ptr (new Task);
+    task_ptr->name = name;
+    task_ptr->period = std::chrono::milliseconds (maximum);
+    task_ptr->minimum = std::chrono::milliseconds (minimum);
+    task_ptr->adaptive = function;
+    task_ptr->overruns = 0;
+    tasks_.push_back (std::move (task_ptr));
+}  // end Adaptive
+
+// Run
+// - sleep until the earliest deadline and run that task until Stop () is
+// - called. Tasks with the same deadline run in the order they were added.
+void Executor::Run () {
+    SteadyClock::time_point start = SteadyClock::now ();
+    for (auto& task_ptr : tasks_) {
+        task_ptr->deadline = start;
+        task_ptr->last_start = start;
+    }
+
+    std::unique_lock <std::mutex> lock (mutex_);
+    while (!stop_ && !tasks_.empty ()) {
+        if (woken_) {
+            woken_ = false;
+            SteadyClock::time_point now = SteadyClock::now ();
+            for (auto& task_ptr : tasks_) {
+                if (task_ptr->adaptive && task_ptr->deadline > now) {
+                    task_ptr->deadline = now;
+                }
+            }
+        }
+
+        Task* task_ptr = Executor::Next ();
+        if (wake_.wait_until (lock, task_ptr->deadline, [this] () {
+                return stop_ || woken_;
+            })) {
+            continue;
+        }
+        lock.unlock ();
+        Executor::Execute (task_ptr);
+        lock.lock ();
+    }
+}  // end Run
+
+// Stop
+// - wake the executor and return from Run () after the current task
+void Executor::Stop () {
+    std::lock_guard <std::mutex> lock (mutex_);
+    stop_ = true;
+    wake_.notify_all ();
+}  // end Stop
+
+// Wake
+// - run the adaptive tasks now instead of at their deadline, safe to call from
+// - any thread
+void Executor::Wake () {
+    std::lock_guard <std::mutex> lock (mutex_);
+    woken_ = true;
+    wake_.notify_all ();
+}  // end Wake
+
+// Next
+// - the task with the earliest deadline, the first added wins a tie
+Executor::Task* Executor::Next () {
+    Task* next_ptr = tasks_.front ().get ();
+    for (auto& task_ptr : tasks_) {
+        if (task_ptr->deadline < next_ptr->deadline) {
+            next_ptr = task_ptr.get ();
+        }
+    }
+    return next_ptr;
+}  // end Next
+
+// Execute
+// - run the task, record its statistics and move its deadline forward. If the
+// - task finished after its next deadline the missed periods are skipped so an
+// - overrun never causes a burst of late runs.
+void Executor::Execute (Task* task_ptr) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    SteadyClock::time_point start = SteadyClock::now ();
+    std::chrono::duration <float, std::milli> delta
+        = start - task_ptr->last_start;
+    task_ptr->last_start = start;
+    double next = 0;
+    if (task_ptr->adaptive) {
+        next = task_ptr->adaptive (delta.count ());
+    } else {
+        task_ptr->function (delta.count ());
+    }
+    SteadyClock::time_point end = SteadyClock::now ();
+
+    task_ptr->jitter.Record (
+        duration_cast <microseconds> (start - task_ptr->deadline).count ());
+    task_ptr->execution.Record (
+        duration_cast <microseconds> (end - start).count ());
+
+    if (task_ptr->adaptive) {
+        // the next run is relative to this start since the prediction is
+        // based on the state at the start, it never counts as an overrun
+        std::chrono::duration <double, std::milli> wait (next);
+        if (!(wait < task_ptr->period)) {
+            wait = task_ptr->period;    // also catches infinity and NaN
+        }
+        if (wait < task_ptr->minimum) {
+            wait = task_ptr->minimum;
+        }
+        task_ptr->deadline = std::max (
+            start + std::chrono::duration_cast <SteadyClock::duration> (wait),
+            end);
+        return;
+    }
+
+    task_ptr->deadline += task_ptr->period;
+    if (task_ptr->deadline <= end) {
+        unsigned long long missed = (end - task_ptr->deadline)
+                                    / task_ptr->period + 1;
+        task_ptr->deadline += missed * task_ptr->period;
+        task_ptr->overruns += missed;
+    }
+}  // end Execute
+
+// Display
+// - print the statistics of every task, safe to call while Run () is active
+void Executor::Display () {
+    std::cout << std::left
+        << std::setw (12) << "Task"
+        << std::setw (12) << "Period"
+        << std::setw (10) << "Runs"
+        << std::setw (10) << "Overruns"
+        << std::setw (30) << "Jitter p50/p99/max (us)"
+        << "Execution p50/p99/max (us)\n";
+    for (auto& task_ptr : tasks_) {
+        const Histogram& jitter = task_ptr->jitter;
+        const Histogram& execution = task_ptr->execution;
+        std::chrono::milliseconds period
+            = std::chrono::duration_cast <std::chrono::milliseconds> (
+                task_ptr->period);
+        std::cout
+            << std::setw (12) << task_ptr->name
+            << std::setw (12)
+            << (task_ptr->adaptive ? "<" : "")
+               + std::to_string (period.count ()) + " ms"
+            << std::setw (10) << execution.Count ()
+            << std::setw (10) << task_ptr->overruns
+            << std::setw (30)
+            << std::to_string (jitter.Percentile (0.5)) + "/"
+               + std::to_string (jitter.Percentile (0.99)) + "/"
+               + std::to_string (jitter.Max ())
+            << execution.Percentile (0.5) << "/"
+            << execution.Percentile (0.99) << "/"
+            << execution.Max () << "\n";
+    }
+    std::cout << std::right << std::endl;
+}  // end Display
@@ -0,0 +1,348 @@
+// INCLUDES
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include "include/Fleet.h"
+
+// this constructor builds the fleet from the [Fleet] units property using
+// [DER] as the default unit and [DER.n] sections as per unit overrides
+Fleet::Fleet (tsu::config_map& configs)
+    : Fleet (configs["DER"],
+             tsu::GetConfig <unsigned int> (configs, "Fleet", "units")) {
+    for (unsigned int i = 0; i < units_; i++) {
+        auto it = configs.find ("DER." + tsu::ToString (i));
+        if (it == configs.end ()) {
+            continue;
+        }
+
+        // overlay the unit section on the default section
+        std::map <std::string, std::string> init = configs["DER"];
+        for (const auto& property : it->second) {
+            init[property.first] = property.second;
+        }
+        Fleet::Initialize (init, i);
+    }
+    Fleet::Publish ();
+}  // end constructor
+
+// this constructor creates (units) identical resources from a [DER] section
+Fleet::Fleet (std::map <std::string, std::string> init, unsigned int units) :
+    units_(units),
+    rated_export_power_(units, 0),
+    rated_export_energy_(units, 0),
+    export_ramp_(units, 0),
+    rated_import_power_(units, 0),
+    rated_import_energy_(units, 0),
+    import_ramp_(units, 0),
+    idle_losses_(units, 0),
+    export_power_(units, 0),
+    export_energy_(units, 0),
+    import_power_(units, 0),
+    import_energy_(units, 0),
+    export_watts_(units, 0),
+    import_watts_(units, 0),
+    watt_hours_(units, 0),
+    commands_(units),
+    pending_(false) {
+    for (unsigned int i = 0; i < units_; i++) {
+        Fleet::Initialize (init, i);
+    }
+    Fleet::Publish ();
+}  // end constructor
+
+Fleet::~Fleet () {
+    // do nothing
+}  // end destructor
+
+// Initialize
+// - set the rated properties of a single unit and randomly assign its energy
+// - capacity the same way DistributedEnergyResource does
+void Fleet::Initialize (std::map <std::string, std::string> init,
+                        unsigned int unit) {
+    rated_export_power_[unit] = stoul(init["rated_export_power"]);
+    rated_export_energy_[unit] = stoul(init["rated_export_energy"]);
+    export_ramp_[unit] = stoul(init["rated_export_ramp"]);
+    rated_import_power_[unit] = stoul(init["rated_import_power"]);
+    rated_import_energy_[unit] = stoul(init["rated_import_energy"]);
+    import_ramp_[unit] = stoul(init["rated_import_ramp"]);
+    idle_losses_[unit] = stoul(init["idle_losses"]);
+
+    // one generator is shared by the fleet since seeding is expensive
+    static std::mt19937 gen {std::random_device {} ()};
+    float mean = stof(init["normal_mean"]);
+    float std_dev = stof(init["standard_deviation"]);
+    std::normal_distribution<double> distribution(mean, std_dev);
+
+    float percent = 2;
+    while (percent > 1 || percent < 0) {
+        percent = distribution (gen);
+    }
+
+    import_energy_[unit] = rated_import_energy_[unit] * percent;
+    export_energy_[unit] = rated_export_energy_[unit] * (1 - percent);
+}  // end Initialize
+
+// Set Export Watts
+// - same as DistributedEnergyResource, export turns import power off
+void Fleet::SetExportWatts (unsigned int unit, unsigned int power) {
+    import_watts_[unit] = 0;
+    import_power_[unit] = 0;
+    export_watts_[unit] = std::min ((float)power, rated_export_power_[unit]);
+}  // end Set Export Watts
+
+// Set Import Watts
+// - same as DistributedEnergyResource, import turns export power off
+void Fleet::SetImportWatts (unsigned int unit, unsigned int power) {
+    export_watts_[unit] = 0;
+    export_power_[unit] = 0;
+    import_watts_[unit] = std::min ((float)power, rated_import_power_[unit]);
+}  // end Set Import Watts
+
+// Queue Export Watts
+// - thread safe SetExportWatts, applied by the next Loop ()
+void Fleet::QueueExportWatts (unsigned int unit, unsigned int power) {
+    commands_[unit].Store (EXPORT, power);
+    pending_.store (true, std::memory_order_release);
+}  // end Queue Export Watts
+
+// Queue Import Watts
+// - thread safe SetImportWatts, applied by the next Loop ()
+void Fleet::QueueImportWatts (unsigned int unit, unsigned int power) {
+    commands_[unit].Store (IMPORT, power);
+    pending_.store (true, std::memory_order_release);
+}  // end Queue Import Watts
+
+// Apply Commands
+// - apply the latest command of every unit, the units are only scanned after
+// - a command was queued
+void Fleet::ApplyCommands () {
+    if (!pending_.exchange (false, std::memory_order_acquire)) {
+        return;
+    }
+    unsigned char tag;
+    unsigned int power;
+    for (unsigned int i = 0; i < units_; i++) {
+        if (commands_[i].Take (tag, power)) {
+            if (tag == IMPORT) {
+                Fleet::SetImportWatts (i, power);
+            } else {
+                Fleet::SetExportWatts (i, power);
+            }
+        }
+    }
+}  // end Apply Commands
+
+// Publish
+// - store the fleet totals for other threads
+void Fleet::Publish () {
+    Snapshot snapshot = {units_, 0, 0, 0, 0, 0, 0};
+    for (unsigned int i = 0; i < units_; i++) {
+        snapshot.importing += import_watts_[i] > 0;
+        snapshot.exporting += export_watts_[i] > 0;
+        snapshot.import_power += import_power_[i];
+        snapshot.import_energy += import_energy_[i];
+        snapshot.export_power += export_power_[i];
+        snapshot.export_energy += export_energy_[i];
+    }
+    snapshot_.Store (snapshot);
+}  // end Publish
+
+// Get Snapshot
+// - consistent copy of the totals published by the last Loop ()
+Fleet::Snapshot Fleet::GetSnapshot () {
+    return snapshot_.Load ();
+}  // end Get Snapshot
+
+// Get Units
+unsigned int Fleet::GetUnits () {
+    return units_;
+}  // end Get Units
+
+unsigned int Fleet::GetExportWatts (unsigned int unit) {
+    return export_watts_[unit];
+}
+
+unsigned int Fleet::GetRatedExportPower (unsigned int unit) {
+    return rated_export_power_[unit];
+}
+
+unsigned int Fleet::GetExportPower (unsigned int unit) {
+    return export_power_[unit];
+}
+
+unsigned int Fleet::GetRatedExportEnergy (unsigned int unit) {
+    return rated_export_energy_[unit];
+}
+
+unsigned int Fleet::GetExportEnergy (unsigned int unit) {
+    return export_energy_[unit];
+}
+
+unsigned int Fleet::GetExportRamp (unsigned int unit) {
+    return export_ramp_[unit];
+}
+
+unsigned int Fleet::GetImportWatts (unsigned int unit) {
+    return import_watts_[unit];
+}
+
+unsigned int Fleet::GetRatedImportPower (unsigned int unit) {
+    return rated_import_power_[unit];
+}
+
+unsigned int Fleet::GetImportPower (unsigned int unit) {
+    return import_power_[unit];
+}
+
+unsigned int Fleet::GetRatedImportEnergy (unsigned int unit) {
+    return rated_import_energy_[unit];
+}
+
+unsigned int Fleet::GetImportEnergy (unsigned int unit) {
+    return import_energy_[unit];
+}
+
+unsigned int Fleet::GetImportRamp (unsigned int unit) {
+    return import_ramp_[unit];
+}
+
+unsigned int Fleet::GetIdleLosses (unsigned int unit) {
+    return idle_losses_[unit];
+}
+
+// Ramp Kernel
+// - ramp (power) towards (watts) and clamp to [0, rated] the same as
+// - SetImportPower/SetExportPower, then add the area under the power curve to
+// - (watt_hours) using (sign) for the direction of energy flow. The curve is
+// - a trapezoid while ramping and flat once the setpoint is reached, so the
+// - area is exact when the ramp ends part way through the step. A direction
+// - without a setpoint holds its power and moves no energy like the DER.
+// - The pointers must not alias so the loop can be vectorized.
+static void RampKernel (size_t units,
+                        float seconds,
+                        float sign,
+                        const float* __restrict watts,
+                        const float* __restrict ramp,
+                        const float* __restrict rated,
+                        float* __restrict power,
+                        float* __restrict watt_hours) {
+    const float per_hour = sign / (60*60);
+    for (size_t i = 0; i < units; i++) {
+        float step = ramp[i] * seconds;
+        float start = power[i];
+        float active = watts[i] > 0 ? 1.0f : 0.0f;
+        float end = start + std::min (std::max (watts[i] - start, -step), step);
+        end = std::min (std::max (end, 0.0f), rated[i]);
+        end = active * end + (1.0f - active) * start;
+        float ramp_seconds = std::min (
+            std::abs (end - start) / std::max (ramp[i], 1e-6f), seconds);
+        power[i] = end;
+        watt_hours[i] += active * per_hour
+                         * ((start + end) * 0.5f * ramp_seconds
+                            + end * (seconds - ramp_seconds));
+    }
+}  // end Ramp Kernel
+
+// Energy Kernel
+// - apply idle losses to units with no setpoint and move (watt_hours) from the
+// - import capacity to the export capacity. The energy moved is bounded by the
+// - room and stored energy the same as DER::ImportPower/ExportPower so what
+// - leaves one capacity always arrives in the other, and the power with a
+// - setpoint stops once its bound is reached like the DER does. The energy is
+// - double so the rounding of a tick does not depend on the capacity size.
+static void EnergyKernel (size_t units,
+                          float seconds,
+                          const float* __restrict import_watts,
+                          const float* __restrict export_watts,
+                          const float* __restrict idle_losses,
+                          const float* __restrict rated_import_energy,
+                          const float* __restrict rated_export_energy,
+                          const float* __restrict watt_hours,
+                          double* __restrict import_energy,
+                          double* __restrict export_energy,
+                          float* __restrict import_power,
+                          float* __restrict export_power) {
+    const double hours = seconds / (60*60);
+    for (size_t i = 0; i < units; i++) {
+        double idle = (import_watts[i] + export_watts[i] == 0) ? 1.0 : 0.0;
+        double delta = watt_hours[i] - idle * idle_losses[i] * hours;
+        double room = std::max (std::min (import_energy[i],
+                                rated_export_energy[i] - export_energy[i]),
+                                0.0);
+        double stored = std::max (std::min (export_energy[i],
+                                  rated_import_energy[i] - import_energy[i]),
+                                  0.0);
+        double moved = std::min (std::max (delta, -stored), room);
+        import_energy[i] -= moved;
+        export_energy[i] += moved;
+        bool import_full = import_watts[i] > 0 && delta >= room;
+        bool export_empty = export_watts[i] > 0 && -delta >= stored;
+        import_power[i] = import_full ? 0.0f : import_power[i];
+        export_power[i] = export_empty ? 0.0f : export_power[i];
+    }
+}  // end Energy Kernel
+
+// Loop
+// - step every unit by (delta_time) milliseconds. Import power moves energy
+// - from the import capacity to the export capacity while export power and
+// - idle losses move it back. Idle losses only apply when both setpoints are
+// - zero. There are no data dependant branches in the kernels. Queued
+// - commands are applied after the physics and the totals are published.
+void Fleet::Loop (float delta_time) {
+    float seconds = delta_time / 1000;
+    std::fill (watt_hours_.begin (), watt_hours_.end (), 0.0f);
+    RampKernel (units_, seconds, 1.0f,
+                import_watts_.data (),
+                import_ramp_.data (),
+                rated_import_power_.data (),
+                import_power_.data (),
+                watt_hours_.data ());
+    RampKernel (units_, seconds, -1.0f,
+                export_watts_.data (),
+                export_ramp_.data (),
+                rated_export_power_.data (),
+                export_power_.data (),
+                watt_hours_.data ());
+    EnergyKernel (units_, seconds,
+                  import_watts_.data (),
+                  export_watts_.data (),
+                  idle_losses_.data (),
+                  rated_import_energy_.data (),
+                  rated_export_energy_.data (),
+                  watt_hours_.data (),
+                  import_energy_.data (),
+                  export_energy_.data (),
+                  import_power_.data (),
+                  export_power_.data ());
+    Fleet::ApplyCommands ();
+    Fleet::Publish ();
+}  // end Loop
+
+// Display
+// - print unit properties to terminal
+void Fleet::Display (unsigned int unit) {
+    std::cout
+        << "Unit:\t\t" << unit << "\n"
+        << "Import Power:\t" << import_power_[unit] << "\twatts\n"
+        << "Import Control:\t" << import_watts_[unit] << "\twatts\n"
+        << "Import Energy:\t" << import_energy_[unit] << "\twatt-hours\n"
+        << "Export Power:\t" << export_power_[unit] << "\twatts\n"
+        << "Export Control:\t" << export_watts_[unit] << "\twatts\n"
+        << "Export Energy:\t" << export_energy_[unit] << "\twatt-hours\n"
+        << std::endl;
+}  // end Display
+
+// Display
+// - print the fleet totals to terminal, safe to call from any thread
+void Fleet::Display () {
+    Snapshot snapshot = Fleet::GetSnapshot ();
+    std::cout
+        << "Fleet Units:\t" << snapshot.units << "\t("
+        << snapshot.importing << " importing, "
+        << snapshot.exporting << " exporting)\n"
+        << "Import Power:\t" << snapshot.import_power << "\twatts\n"
+        << "Import Energy:\t" << snapshot.import_energy << "\twatt-hours\n"
+        << "Export Power:\t" << snapshot.export_power << "\twatts\n"
+        << "Export Energy:\t" << snapshot.export_energy << "\twatt-hours\n"
+        << std::endl;
+}  // end Display
@@ -0,0 +1,350 @@
+// INCLUDES
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <chrono>
+#include "include/LogWriter.h"
+
+// every binary file starts with this header so the converter can check it
+static const char telemetry_magic[8] = {'D','C','S','T','L','M','1','\n'};
+
+// Set Destination
+// - copy the context and path, they are truncated to fit the record
+void LogRecord::SetDestination (const std::string& context,
+								const std::string& path) {
+	snprintf (LogRecord::context, sizeof (LogRecord::context), "%s",
+			  context.c_str ());
+	snprintf (LogRecord::path, sizeof (LogRecord::path), "%s", path.c_str ());
+}  // end Set Destination
+
+// Set Data
+// - copy a text message, true if it had to be truncated
+bool LogRecord::SetData (const std::string& text) {
+	return LogRecord::SetData (text.data (), text.size ());
+}  // end Set Data
+
+// Set Data
+// - copy raw bytes, true if they had to be truncated
+bool LogRecord::SetData (const void* bytes, size_t count) {
+	truncated = count > sizeof (data);
+	size = truncated ? sizeof (data) : count;
+	memcpy (data, bytes, size);
+	return truncated;
+}  // end Set Data
+
+// Get
+// - the writer is created on first use so it is ready before any Logger
+LogWriter& LogWriter::Get () {
+	static LogWriter writer (1024, 100);
+	return writer;
+}  // end Get
+
+// the constructor allocates the ring buffer and starts the writer thread
+LogWriter::LogWriter (size_t capacity, unsigned int interval)
+	: ring_(capacity),
+	  interval_(interval),
+	  asleep_(AWAKE),
+	  done_(false),
+	  wake_(false),
+	  blocking_(false),
+	  pushed_(0),
+	  written_(0),
+	  dropped_(0),
+	  overflows_(0),
+	  truncated_(0),
+	  batches_(0),
+	  last_second_(-1) {
+	sem_init (&semaphore_, 0, 0);
+	thread_ = std::thread (&LogWriter::Loop, this);
+}  // end constructor
+
+LogWriter::~LogWriter () {
+	LogWriter::Stop ();
+	sem_destroy (&semaphore_);
+}  // end destructor
+
+// Push
+// - copy the record into the ring buffer. This is the only work done by the
+// - calling thread. When the buffer is full the record is dropped unless the
+// - writer was set to blocking.
+bool LogWriter::Push (const LogRecord& record) {
+	if (record.truncated) {
+		truncated_++;
+	}
+	bool overflow = false;
+	while (!ring_.Push (record)) {
+		if (!overflow) {
+			overflows_++;
+			overflow = true;
+		}
+		if (!blocking_ || done_) {
+			dropped_++;
+			return false;
+		}
+		LogWriter::Wake ();
+		std::this_thread::yield ();
+	}
+	pushed_++;
+
+	// a record ends an idle sleep and a half full buffer is written now. The
+	// fence orders the push before the read of (asleep_)
+	if (ring_.Size () > ring_.Capacity () / 2) {
+		LogWriter::Wake ();
+	} else {
+		std::atomic_thread_fence (std::memory_order_seq_cst);
+		int idle = IDLE;
+		if (asleep_.compare_exchange_strong (idle, AWAKE)) {
+			sem_post (&semaphore_);
+		}
+	}
+	return true;
+}  // end Push
+
+// Push
+// - queue a binary telemetry record
+bool LogWriter::Push (const std::string& context,
+					  const std::string& path,
+					  const TelemetryRecord& telemetry) {
+	LogRecord record;
+	record.format = LogRecord::BINARY;
+	record.utc_ms = telemetry.utc_ms;
+	record.SetDestination (context, path);
+	record.SetData (&telemetry, sizeof (telemetry));
+	return LogWriter::Push (record);
+}  // end Push
+
+// Set Blocking
+// - simulations that produce records faster than real-time can wait for the
+// - writer instead of dropping records
+void LogWriter::SetBlocking (bool blocking) {
+	blocking_ = blocking;
+}  // end Set Blocking
+
+// Flush
+// - wait until every record pushed before this call has been written
+void LogWriter::Flush () {
+	unsigned long long target = pushed_;
+	while (written_ < target && !done_) {
+		LogWriter::Wake ();
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+}  // end Flush
+
+// Stop
+// - write the remaining records, close the files and join the thread
+void LogWriter::Stop () {
+	if (done_.exchange (true)) {
+		return;
+	}
+	LogWriter::Wake ();
+	if (thread_.joinable ()) {
+		thread_.join ();
+	}
+}  // end Stop
+
+// Wake
+// - write the buffer now instead of waiting for the batch to fill
+void LogWriter::Wake () {
+	wake_ = true;
+	if (asleep_.exchange (AWAKE) != AWAKE) {
+		sem_post (&semaphore_);
+	}
+}  // end Wake
+
+// Sleep
+// - wait on the semaphore until a producer or Wake () ends the (state) sleep,
+// - a BATCH sleep gives up after (interval_). Whoever sets (asleep_) back to
+// - AWAKE posts once, so if it was not the writer the post is taken here
+void LogWriter::Sleep (int state) {
+	asleep_ = state;
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	bool ready = done_ || wake_ || (state == IDLE && ring_.Size () > 0);
+	if (!ready && state == IDLE) {
+		while (sem_wait (&semaphore_) != 0 && errno == EINTR) {}
+		return;
+	}
+	if (!ready) {
+		struct timespec deadline;
+		clock_gettime (CLOCK_REALTIME, &deadline);
+		deadline.tv_nsec += (interval_ % 1000) * 1000000L;
+		deadline.tv_sec += interval_ / 1000 + deadline.tv_nsec / 1000000000L;
+		deadline.tv_nsec %= 1000000000L;
+		int result;
+		while ((result = sem_timedwait (&semaphore_, &deadline)) != 0
+			   && errno == EINTR) {}
+		if (result == 0) {
+			return;
+		}
+	}
+	if (asleep_.exchange (AWAKE) == AWAKE) {
+		while (sem_wait (&semaphore_) != 0 && errno == EINTR) {}
+	}
+}  // end Sleep
+
+// Display
+// - print the writer counters to terminal
+void LogWriter::Display () {
+	std::cout
+		<< "Log Written:\t" << written_ << "\trecords\n"
+		<< "Log Batches:\t" << batches_ << "\tbatches\n"
+		<< "Log Dropped:\t" << dropped_ << "\trecords\n"
+		<< "Log Overflows:\t" << overflows_ << "\tfull buffer\n"
+		<< "Log Truncated:\t" << truncated_ << "\trecords\n"
+		<< "Log Buffer:\t" << ring_.Size () << "/" << ring_.Capacity ()
+		<< "\trecords\n" << std::endl;
+}  // end Display
+
+unsigned long long LogWriter::GetWritten () {
+	return written_;
+}
+
+unsigned long long LogWriter::GetDropped () {
+	return dropped_;
+}
+
+unsigned long long LogWriter::GetOverflows () {
+	return overflows_;
+}
+
+unsigned long long LogWriter::GetTruncated () {
+	return truncated_;
+}
+
+unsigned long long LogWriter::GetBatches () {
+	return batches_;
+}
+
+// Loop
+// - writer thread, drain the ring buffer then flush the files once per batch
+void LogWriter::Loop () {
+	LogRecord record;
+	while (true) {
+		bool done = done_;
+		unsigned long long count = 0;
+		while (ring_.Pop (record)) {
+			LogWriter::Write (record);
+			count++;
+		}
+
+		if (count > 0) {
+			for (auto& file : files_) {
+				fflush (file.second.file);
+			}
+			batches_++;
+			written_ += count;
+		}
+
+		// records pushed before (done) was set have been written
+		if (done) {
+			break;
+		}
+
+		// sleep until there is something to write, then give the batch
+		// (interval_) to fill unless it is needed now
+		LogWriter::Sleep (IDLE);
+		LogWriter::Sleep (BATCH);
+		wake_ = false;
+	}
+	LogWriter::Close ();
+}  // end Loop
+
+// Write
+// - write one record to its file, opening a new file when the date changes
+void LogWriter::Write (const LogRecord& record) {
+	time_t second = record.utc_ms / 1000;
+	if (second != last_second_) {
+		struct tm ts;
+		localtime_r (&second, &ts);
+		strftime (date_, sizeof (date_), "%F", &ts);
+		strftime (date_time_, sizeof (date_time_), "%F %T", &ts);
+		last_second_ = second;
+	}
+
+	bool binary = record.format == LogRecord::BINARY;
+	std::string key = std::string (record.path) + record.context
+		+ (binary ? ".bin" : ".log");
+	File& file = files_[key];
+	if (file.date != date_) {
+		if (file.file) {
+			fclose (file.file);
+		}
+		std::string name = std::string (record.path) + record.context + "_"
+			+ date_ + (binary ? ".bin" : ".log");
+		file.file = fopen (name.c_str (), binary ? "ab" : "a");
+		file.date = date_;
+
+		// new binary files start with the header
+		if (file.file && binary) {
+			fseek (file.file, 0, SEEK_END);
+			if (ftell (file.file) == 0) {
+				fwrite (telemetry_magic, sizeof (telemetry_magic), 1,
+						file.file);
+			}
+		}
+	}
+	if (!file.file) {
+		return;
+	}
+
+	if (binary) {
+		fwrite (record.data, record.size, 1, file.file);
+	} else {
+		fputs (date_time_, file.file);
+		fputc ('\t', file.file);
+		fwrite (record.data, record.size, 1, file.file);
+		fputc ('\n', file.file);
+	}
+}  // end Write
+
+// Close
+// - close every open file
+void LogWriter::Close () {
+	for (auto& file : files_) {
+		if (file.second.file) {
+			fclose (file.second.file);
+		}
+	}
+	files_.clear ();
+}  // end Close
+
+// Format Telemetry
+// - the same tab separated layout DistributedEnergyResource::Log writes
+std::string LogWriter::FormatTelemetry (const TelemetryRecord& telemetry,
+										const char* date_time) {
+	std::ostringstream ss;
+	ss << date_time << "\t"
+		<< telemetry.import_watts << "\t"
+		<< telemetry.import_power << "\t"
+		<< telemetry.import_energy << "\t"
+		<< telemetry.export_watts << "\t"
+		<< telemetry.export_power << "\t"
+		<< telemetry.export_energy << "\t";
+	return ss.str ();
+}  // end Format Telemetry
+
+// Convert Telemetry
+// - read a binary telemetry file and write each record as a text line
+bool LogWriter::ConvertTelemetry (const std::string& filename,
+								  std::ostream& output) {
+	std::ifstream file (filename, std::ios::binary);
+	char magic[sizeof (telemetry_magic)];
+	if (!file.read (magic, sizeof (magic))
+		|| memcmp (magic, telemetry_magic, sizeof (magic)) != 0) {
+		std::cout << "[ERROR]...not a telemetry log: " << filename << "\n";
+		return false;
+	}
+
+	TelemetryRecord telemetry;
+	char date_time[32];
+	while (file.read ((char*)&telemetry, sizeof (telemetry))) {
+		time_t second = telemetry.utc_ms / 1000;
+		struct tm ts;
+		localtime_r (&second, &ts);
+		strftime (date_time, sizeof (date_time), "%F %T", &ts);
+		output << LogWriter::FormatTelemetry (telemetry, date_time) << '\n';
+	}
+	return true;
+}  // end Convert Telemetry
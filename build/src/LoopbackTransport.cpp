@@ -0,0 +1,140 @@
+// INCLUDES
+#include "include/LoopbackTransport.h"
+
+LoopbackTransport::LoopbackTransport () : device_ptr_(NULL),
+                                          server_ptr_(NULL),
+                                          stop_(false),
+                                          delivered_(0) {
+}  // end constructor
+
+LoopbackTransport::~LoopbackTransport () {
+    // do nothing
+}  // end destructor
+
+// Set Device Handler
+// - set before Run () starts
+void LoopbackTransport::SetDeviceHandler (DeviceHandler* handler_ptr) {
+    device_ptr_ = handler_ptr;
+}  // end Set Device Handler
+
+// Set Server Handler
+// - set before Run () starts
+void LoopbackTransport::SetServerHandler (ServerHandler* handler_ptr) {
+    server_ptr_ = handler_ptr;
+}  // end Set Server Handler
+
+// Set Properties Listener
+// - set before the device emits
+void LoopbackTransport::SetPropertiesListener (PropertiesListener listener) {
+    listener_ = listener;
+}  // end Set Properties Listener
+
+// Emit Properties Changed
+// - pass the properties to the listener on this thread
+bool LoopbackTransport::EmitPropertiesChanged (const char** props,
+                                               const unsigned int* values,
+                                               size_t count) {
+    if (listener_) {
+        listener_ (props, values, count);
+    }
+    return true;
+}  // end Emit Properties Changed
+
+void LoopbackTransport::ImportPower (unsigned int watts) {
+    LoopbackTransport::Send (Message::IMPORT_POWER, watts);
+}
+
+void LoopbackTransport::ExportPower (unsigned int watts) {
+    LoopbackTransport::Send (Message::EXPORT_POWER, watts);
+}
+
+void LoopbackTransport::ChangePrice (int price) {
+    LoopbackTransport::Send (Message::PRICE, price);
+}
+
+void LoopbackTransport::ChangeTime (unsigned int utc) {
+    LoopbackTransport::Send (Message::TIME, utc);
+}
+
+// Send
+// - queue a message for the dispatch thread
+void LoopbackTransport::Send (Message::Type type, unsigned int value) {
+    Message message;
+    message.type = type;
+    message.value = value;
+    message.sent = SteadyClock::now ();
+    std::lock_guard <std::mutex> lock (mutex_);
+    messages_.push_back (message);
+    wake_.notify_one ();
+}  // end Send
+
+// Run
+// - deliver the queued messages in order until Stop () is called, messages
+// - still queued when it stops are dropped
+void LoopbackTransport::Run () {
+    std::deque <Message> batch;
+    std::unique_lock <std::mutex> lock (mutex_);
+    while (true) {
+        wake_.wait (lock, [this] () { return stop_ || !messages_.empty (); });
+        if (stop_) {
+            break;
+        }
+        // deliver without the lock so senders are never blocked by handlers
+        batch.swap (messages_);
+        lock.unlock ();
+        for (const Message& message : batch) {
+            LoopbackTransport::Deliver (message);
+        }
+        batch.clear ();
+        lock.lock ();
+    }
+}  // end Run
+
+// Stop
+// - return from Run () after the current batch
+void LoopbackTransport::Stop () {
+    std::lock_guard <std::mutex> lock (mutex_);
+    stop_ = true;
+    wake_.notify_all ();
+}  // end Stop
+
+// Deliver
+// - record the queue latency and pass the message to its handler
+void LoopbackTransport::Deliver (const Message& message) {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+
+    SteadyClock::duration queued = SteadyClock::now () - message.sent;
+    latency_.Record (duration_cast <nanoseconds> (queued).count ());
+    delivered_.fetch_add (1, std::memory_order_relaxed);
+    switch (message.type) {
+        case Message::IMPORT_POWER:
+            if (device_ptr_) {
+                device_ptr_->ImportPower (message.value);
+            }
+            break;
+        case Message::EXPORT_POWER:
+            if (device_ptr_) {
+                device_ptr_->ExportPower (message.value);
+            }
+            break;
+        case Message::PRICE:
+            if (server_ptr_) {
+                server_ptr_->PriceChanged ((int)message.value);
+            }
+            break;
+        case Message::TIME:
+            if (server_ptr_) {
+                server_ptr_->TimeChanged (message.value);
+            }
+            break;
+    }
+}  // end Deliver
+
+const Histogram& LoopbackTransport::GetLatency () const {
+    return latency_;
+}
+
+unsigned long long LoopbackTransport::GetDelivered () const {
+    return delivered_.load (std::memory_order_relaxed);
+}
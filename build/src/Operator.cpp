@@ -1,22 +1,20 @@
 // INCLUDES
 #include <iostream>
+#include <algorithm>
 #include <ctime>
 #include "include/Operator.h"
 #include "include/tsu.h"
+#include "include/Clock.h"
 
-// the constructor reads the given schedule and stores it in memory
-Operator::Operator (const std::string& filename, 
-                    DistributedEnergyResource* der_ptr) 
-    : index_(0), der_ptr_(der_ptr) {
-    tsu::string_matrix matrix = tsu::FileToMatrix(filename, ',', 3);
-
-    // reserve memory for each row within the matrix
-    schedule_.reserve(matrix.size());
+static const unsigned int seconds_per_day = 60*60*24;
 
-    // loop through each row of the matrix and set each column to it's
-    // header data type
-    for (const auto &col : matrix) {
-        schedule_.emplace_back (stoi(col[0]), col[1], stoul(col[2]));
+// the constructor reads the given schedule and stores it in memory
+Operator::Operator (const std::string& filename,
+                    DistributedEnergyResource* der_ptr)
+    : der_ptr_(der_ptr), cursor_(0), last_utc_(0) {
+    schedule_ = Operator::Compile (filename);
+    if (!schedule_) {
+        schedule_ = std::make_shared <Schedule> ();
     }
 }  // end constructor
 
@@ -24,37 +22,154 @@ Operator::~Operator () {
     // do nothing
 }  // end destructor
 
+// Compile
+// - read the schedule file and convert each row to it's header data type.
+// - The rows are sorted by time of day, rows with the same time keep the file
+// - order. Invalid rows are reported with their line number and skipped.
+// - Returns NULL if the file can not be read.
+std::shared_ptr <const Operator::Schedule> Operator::Compile (
+    const std::string& filename) {
+    std::shared_ptr <Schedule> schedule = std::make_shared <Schedule> ();
+    bool read = tsu::ParseCSV(filename, ',',
+        [&] (size_t line, const std::vector <std::string_view>& cells) {
+            ScheduleHeader row;
+            unsigned long long utc;
+            if (cells.size() != 3
+                || !tsu::ParseNumber(cells[0], utc)
+                || !tsu::ParseNumber(cells[2], row.setting)) {
+                std::cout << "[ERROR]: " << filename << ":" << line
+                    << ": invalid schedule row\n";
+                return;
+            }
+            row.time = utc % seconds_per_day;
+
+            std::string_view control = tsu::Trim(cells[1]);
+            if (control == "import") {
+                row.control = IMPORT;
+            } else if (control == "export") {
+                row.control = EXPORT;
+            } else {
+                row.control = IDLE;
+            }
+            schedule->push_back(row);
+        }
+    );
+    if (!read) {
+        std::cout << "[ERROR]: unable to read schedule " << filename << "\n";
+        return NULL;
+    }
+
+    std::stable_sort(schedule->begin(), schedule->end(),
+        [] (const ScheduleHeader& lhs, const ScheduleHeader& rhs) {
+            return lhs.time < rhs.time;
+        }
+    );
+    return schedule;
+}  // end Compile
+
+// Reload
+// - compile a new schedule file and swap it in. The control loop only
+// - sees the swap of the pointer so it is never waiting on the file.
+bool Operator::Reload (const std::string& filename) {
+    std::shared_ptr <const Schedule> schedule = Operator::Compile (filename);
+    if (!schedule) {
+        return false;
+    }
+    std::atomic_store (&schedule_, schedule);
+    return true;
+}  // end Reload
+
+// Seek
+// - move the cursor to the first row after (utc) without dispatching
+void Operator::Seek (unsigned int utc) {
+    const Schedule& rows = *active_;
+    ScheduleHeader key = {utc % seconds_per_day, IDLE, 0};
+    auto it = std::upper_bound(rows.begin(), rows.end(), key,
+        [] (const ScheduleHeader& lhs, const ScheduleHeader& rhs) {
+            return lhs.time < rhs.time;
+        }
+    );
+    cursor_ = (it == rows.end()) ? 0 : it - rows.begin();
+}  // end Seek
+
+// Dispatch
+// - queue the row control for the der
+void Operator::Dispatch (const ScheduleHeader& row) {
+    switch (row.control) {
+        case IMPORT:
+            der_ptr_->QueueImportWatts(row.setting);
+            break;
+        case EXPORT:
+            der_ptr_->QueueExportWatts(row.setting);
+            break;
+        default:
+            der_ptr_->QueueImportWatts(0);
+            break;
+    }
+}  // end Dispatch
+
 // Loop
 // - gets the utc time and takes the modulus so the actual day of the scheduel
-// - is neglected.
+// - is neglected. Every row that came due since the last call is dispatched
+// - in order, so a late call catches up instead of missing rows.
 void Operator::Loop () {
-    // get the current time utc and take modulo to neglect days
-    unsigned int seconds_per_day = 60*60*24;
-    unsigned int utc = time(NULL) % seconds_per_day;
+    unsigned int utc = Clock::Get ()->Now ();
+    std::shared_ptr <const Schedule> schedule = std::atomic_load (&schedule_);
+
+    // a new schedule or a clock jump (first call, time set backwards or
+    // more than a day passed) only moves the cursor
+    if (schedule != active_ || last_utc_ == 0 || utc < last_utc_
+        || utc - last_utc_ >= seconds_per_day) {
+        active_ = schedule;
+        last_utc_ = utc;
+        Operator::Seek (utc);
+        return;
+    }
 
-    // loop through each row of schedule looking for current time
-    for (unsigned int i = index_; i < schedule_.size(); i++) {
-        ScheduleHeader& row = schedule_[i];
+    const Schedule& rows = *active_;
+    unsigned int elapsed = utc - last_utc_;
+    unsigned int last = last_utc_ % seconds_per_day;
+    for (unsigned int i = 0; i < rows.size() && elapsed > 0; i++) {
+        const ScheduleHeader& row = rows[cursor_];
 
-        if (row.time % seconds_per_day == utc && index_ != i) {
+        // seconds after the last call that this row is due
+        unsigned int due = (row.time + seconds_per_day - last)
+            % seconds_per_day;
+        if (due == 0 || due > elapsed) {
+            break;
+        }
+        Operator::Dispatch (row);
+        cursor_ = (cursor_ + 1) % rows.size();
+    }
+    last_utc_ = utc;
+}  // end Loop
 
-            // if the time is found check control type
-            if (row.control == "import") {
-                der_ptr_->SetImportWatts(row.setting);
-            } else if (row.control == "export") {
-                der_ptr_->SetExportWatts(row.setting);
-            } else {
-                der_ptr_->SetImportWatts(0);
-            }
+// Pause
+// - called instead of Loop () while the operator is disabled so the rows of
+// - the disabled period are skipped and the next Loop () seeks from its time
+void Operator::Pause () {
+    last_utc_ = 0;
+}  // end Pause
 
-            // log index so multiple controls are not sent and to reduce
-            // search time.
+// Next Event Time
+// - the first utc time after (utc) where a schedule row is due. This lets
+// - the EventScheduler call Loop () only when it has something to do.
+unsigned int Operator::NextEventTime (unsigned int utc) {
+    std::shared_ptr <const Schedule> schedule = std::atomic_load (&schedule_);
+    const Schedule& rows = *schedule;
+    unsigned int day = utc - utc % seconds_per_day;
+    if (rows.empty()) {
+        return utc + seconds_per_day;
+    }
 
-    	    if (i == schedule_.size() - 1) {
-    		  index_ = 0;
-    	    } else {
-    		  index_ = i;
-    	    }
+    ScheduleHeader key = {utc % seconds_per_day, IDLE, 0};
+    auto it = std::upper_bound(rows.begin(), rows.end(), key,
+        [] (const ScheduleHeader& lhs, const ScheduleHeader& rhs) {
+            return lhs.time < rhs.time;
         }
+    );
+    if (it == rows.end()) {
+        return day + seconds_per_day + rows.front().time;
     }
-}  // end Loop
\ No newline at end of file
+    return day + it->time;
+}  // end Next Event Time
@@ -0,0 +1,293 @@
+// INCLUDES
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "include/TelemetryPublisher.h"
+
+// property names in the same order as the Property enum
+const char* TelemetryPublisher::names[PROPERTIES] = {
+    "rated_export_power",
+    "export_power",
+    "rated_export_energy",
+    "export_energy",
+    "export_ramp",
+    "rated_import_power",
+    "import_power",
+    "rated_import_energy",
+    "import_energy",
+    "import_ramp",
+    "idle_losses"
+};
+
+// property indices sorted by name for Find ()
+static const int sorted_names[TelemetryPublisher::PROPERTIES] = {
+    TelemetryPublisher::EXPORT_ENERGY,
+    TelemetryPublisher::EXPORT_POWER,
+    TelemetryPublisher::EXPORT_RAMP,
+    TelemetryPublisher::IDLE_LOSSES,
+    TelemetryPublisher::IMPORT_ENERGY,
+    TelemetryPublisher::IMPORT_POWER,
+    TelemetryPublisher::IMPORT_RAMP,
+    TelemetryPublisher::RATED_EXPORT_ENERGY,
+    TelemetryPublisher::RATED_EXPORT_POWER,
+    TelemetryPublisher::RATED_IMPORT_ENERGY,
+    TelemetryPublisher::RATED_IMPORT_POWER
+};
+
+// Constructor
+// - read the minimum interval (s) and the <property>_absolute and
+// - <property>_relative deadbands, missing deadbands send any change
+TelemetryPublisher::TelemetryPublisher (
+    std::map <std::string, std::string> init) : polled_time_(0),
+                                                min_interval_(300000),
+                                                last_message_(0),
+                                                interval_start_(0),
+                                                messages_sent_(0),
+                                                messages_suppressed_(0),
+                                                properties_sent_(0),
+                                                properties_suppressed_(0) {
+    if (!init["min_interval"].empty ()) {
+        min_interval_ = stoul (init["min_interval"]) * 1000;
+    }
+    for (int i = 0; i < PROPERTIES; i++) {
+        std::string name = names[i];
+        std::string absolute = init[name + "_absolute"];
+        std::string relative = init[name + "_relative"];
+        deadbands_[i].absolute = absolute.empty () ? 0 : stof (absolute);
+        deadbands_[i].relative = relative.empty () ? 0 : stof (relative);
+        sent_[i] = 0;
+        dirty_[i] = false;
+        changed_[i] = false;
+        polled_[i] = 0;
+        selected_[i] = false;
+    }
+}  // end Constructor
+
+TelemetryPublisher::~TelemetryPublisher () {
+    // do nothing
+}  // end Destructor
+
+// Find
+// - binary search of the property names, -1 if the name is unknown
+int TelemetryPublisher::Find (const char* name) {
+    int low = 0, high = PROPERTIES - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        int cmp = strcmp (name, names[sorted_names[mid]]);
+        if (cmp == 0) {
+            return sorted_names[mid];
+        } else if (cmp < 0) {
+            high = mid - 1;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return -1;
+}  // end Find
+
+// Value
+// - the property as it is sent to the server
+unsigned int TelemetryPublisher::Value (
+    int property,
+    const DistributedEnergyResource::Snapshot& der) {
+    switch (property) {
+        case RATED_EXPORT_POWER: return der.rated_export_power;
+        case EXPORT_POWER: return (unsigned int)der.export_power;
+        case RATED_EXPORT_ENERGY: return der.rated_export_energy;
+        case EXPORT_ENERGY: return (unsigned int)der.export_energy;
+        case EXPORT_RAMP: return der.export_ramp;
+        case RATED_IMPORT_POWER: return der.rated_import_power;
+        case IMPORT_POWER: return (unsigned int)der.import_power;
+        case RATED_IMPORT_ENERGY: return der.rated_import_energy;
+        case IMPORT_ENERGY: return (unsigned int)der.import_energy;
+        case IMPORT_RAMP: return der.import_ramp;
+        case IDLE_LOSSES: return der.idle_losses;
+        default: return 0;
+    }
+}  // end Value
+
+// Reset
+// - treat every property as sent with its current value
+void TelemetryPublisher::Reset (
+    const DistributedEnergyResource::Snapshot& der) {
+    for (int i = 0; i < PROPERTIES; i++) {
+        sent_[i] = TelemetryPublisher::Value (i, der);
+        dirty_[i] = false;
+        changed_[i] = false;
+        selected_[i] = false;
+    }
+}  // end Reset
+
+// Poll
+// - mark properties outside their deadband as dirty and, once the minimum
+// - interval has passed, copy the dirty names into props and return the count.
+// - force is the heartbeat and sends every property without waiting for the
+// - interval. Call Commit () after sending. Only one thread may call Poll ()
+size_t TelemetryPublisher::Poll (
+    const DistributedEnergyResource::Snapshot& der,
+    unsigned long long time,
+    bool force,
+    const char** props) {
+    if (time < interval_start_ || time - interval_start_ >= min_interval_) {
+        TelemetryPublisher::CountSuppressed ();
+        interval_start_ = time;
+    }
+
+    unsigned int values[PROPERTIES];
+    bool dirty = false;
+    for (int i = 0; i < PROPERTIES; i++) {
+        values[i] = TelemetryPublisher::Value (i, der);
+        unsigned int last = sent_[i].load (std::memory_order_relaxed);
+        if (values[i] == last) {
+            dirty_[i] = false;  // Get () may have sent it already
+        } else {
+            changed_[i] = true;
+
+            // the absolute deadband keeps values near zero from flapping
+            float delta = std::abs ((float)values[i] - (float)last);
+            float limit = std::max (deadbands_[i].absolute,
+                                    deadbands_[i].relative * last);
+            if (delta > limit) {
+                dirty_[i] = true;
+            }
+        }
+        dirty_[i] = dirty_[i] || force;
+        dirty = dirty || dirty_[i];
+    }
+
+    bool due = force || time < last_message_
+               || time - last_message_ >= min_interval_;
+    if (!dirty || !due) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < PROPERTIES; i++) {
+        selected_[i] = dirty_[i];
+        polled_[i] = values[i];
+        if (dirty_[i]) {
+            props[count++] = names[i];
+        }
+    }
+    polled_time_ = time;
+    return count;
+}  // end Poll
+
+// Commit
+// - record whether the properties returned by the last Poll () were sent. A
+// - failed message keeps them dirty and is retried after the minimum interval
+void TelemetryPublisher::Commit (bool sent) {
+    last_message_ = polled_time_;
+    if (!sent) {
+        return;
+    }
+    size_t count = 0;
+    for (int i = 0; i < PROPERTIES; i++) {
+        if (selected_[i]) {
+            sent_[i].store (polled_[i], std::memory_order_relaxed);
+            dirty_[i] = false;
+            changed_[i] = false;
+            selected_[i] = false;
+            count++;
+        }
+    }
+    messages_sent_++;
+    properties_sent_ += count;
+
+    // changes left out of the message are suppressed for this interval
+    for (int i = 0; i < PROPERTIES; i++) {
+        if (changed_[i]) {
+            properties_suppressed_++;
+            changed_[i] = false;
+        }
+    }
+    interval_start_ = polled_time_;
+}  // end Commit
+
+// Count Suppressed
+// - an interval with changes that were not sent is one suppressed message
+void TelemetryPublisher::CountSuppressed () {
+    size_t count = 0;
+    for (int i = 0; i < PROPERTIES; i++) {
+        if (changed_[i]) {
+            changed_[i] = false;
+            count++;
+        }
+    }
+    if (count > 0) {
+        messages_suppressed_++;
+        properties_suppressed_ += count;
+    }
+}  // end Count Suppressed
+
+// Mark Sent
+// - record a value the server read with Get ()
+void TelemetryPublisher::MarkSent (int property, unsigned int value) {
+    if (property >= 0 && property < PROPERTIES) {
+        sent_[property].store (value, std::memory_order_relaxed);
+    }
+}  // end Mark Sent
+
+// Energy Margin
+// - watt-hours the import or export energy can still move before it leaves
+// - its deadband, used to predict when the next message will be needed. One
+// - watt-hour is added since the sent values are truncated to whole numbers.
+// - Energy that is already outside its deadband is waiting to be sent and
+// - does not need a prediction.
+double TelemetryPublisher::EnergyMargin (
+    const DistributedEnergyResource::Snapshot& der) {
+    const int properties[] = {IMPORT_ENERGY, EXPORT_ENERGY};
+    const double energies[] = {der.import_energy, der.export_energy};
+    double margin = std::numeric_limits <double>::infinity ();
+    for (int i = 0; i < 2; i++) {
+        int property = properties[i];
+        double last = sent_[property].load (std::memory_order_relaxed);
+        double limit = std::max (deadbands_[property].absolute,
+                                 deadbands_[property].relative * (float)last);
+        double left = limit - std::abs (energies[i] - last);
+        if (left >= 0) {
+            margin = std::min (margin, left + 1);
+        }
+    }
+    return margin;
+}  // end Energy Margin
+
+// Next Due
+// - (ms) time the dirty properties can be sent without a new snapshot, the
+// - largest value when nothing is waiting for the minimum interval
+unsigned long long TelemetryPublisher::NextDue () {
+    for (int i = 0; i < PROPERTIES; i++) {
+        if (dirty_[i]) {
+            return last_message_ + min_interval_;
+        }
+    }
+    return std::numeric_limits <unsigned long long>::max ();
+}  // end Next Due
+
+// Display
+// - print the message counters
+void TelemetryPublisher::Display () {
+    std::cout
+        << "Telemetry Messages:\t" << messages_sent_ << "\tsent\t"
+        << messages_suppressed_ << "\tsuppressed\n"
+        << "Telemetry Properties:\t" << properties_sent_ << "\tsent\t"
+        << properties_suppressed_ << "\tsuppressed\n" << std::endl;
+}  // end Display
+
+unsigned long long TelemetryPublisher::GetMessagesSent () {
+    return messages_sent_;
+}
+
+unsigned long long TelemetryPublisher::GetMessagesSuppressed () {
+    return messages_suppressed_;
+}
+
+unsigned long long TelemetryPublisher::GetPropertiesSent () {
+    return properties_sent_;
+}
+
+unsigned long long TelemetryPublisher::GetPropertiesSuppressed () {
+    return properties_suppressed_;
+}
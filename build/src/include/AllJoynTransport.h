@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *    Copyright (c) V2 Systems, LLC.  All rights reserved.
+ *
+ *    All rights reserved. This program and the accompanying materials are
+ *    made available under the terms of the Apache License, Version 2.0
+ *    which accompanies this distribution, and is available at
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for
+ *    any purpose with or without fee is hereby granted, provided that the
+ *    above copyright notice and this permission notice appear in all
+ *    copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ *    WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ *    WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ *    AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ *    DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ *    PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ *    TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ *    PERFORMANCE OF THIS SOFTWARE.
+**********************************************************/
+
+// Author: Tylor Slay
+// Description:
+//      The AllJoyn transport is the device's bus object and the observer's
+//      listener for the server. Method calls and property changes from the
+//      server are parsed from their MsgArgs and passed to the handlers, and
+//      EmitPropertiesChanged () emits the org.freedesktop.DBus.Properties
+//      PropertiesChanged signal with the values it is given.
+//      ~ reference Transport.h
+
+#ifndef ALLJOYNTRANSPORT_HPP_INCLUDED
+#define ALLJOYNTRANSPORT_HPP_INCLUDED
+
+#include <alljoyn/Status.h>
+#include <alljoyn/BusObject.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/ProxyBusObject.h>
+#include <alljoyn/Observer.h>
+#include "Transport.h"
+
+class AllJoynTransport : public Transport,
+                         public ajn::BusObject,
+                         public ajn::Observer::Listener,
+                         public ajn::ProxyBusObject::PropertiesChangedListener {
+    static const char* server_props[];
+
+public:
+    // member methods
+    AllJoynTransport (ajn::BusAttachment* bus_ptr,
+                      const char* device_interface,
+                      const char* path,
+                      const char* server_interface
+    );
+    void SetDeviceHandler (DeviceHandler* handler_ptr);
+    void SetServerHandler (ServerHandler* handler_ptr);
+    bool EmitPropertiesChanged (const char** props,
+                                const unsigned int* values,
+                                size_t count);
+
+    // bus object
+    void ImportPowerHandler (const ajn::InterfaceDescription::Member* member,
+                             ajn::Message& message
+    );
+    void ExportPowerHandler (const ajn::InterfaceDescription::Member* member,
+                             ajn::Message& message
+    );
+    QStatus Get (const char* interface,
+                 const char* property,
+                 ajn::MsgArg& value
+    );
+
+    // observer listener
+    virtual void ObjectDiscovered (ajn::ProxyBusObject& proxy);
+    virtual void ObjectLost (ajn::ProxyBusObject& proxy);
+    virtual void PropertiesChanged (ajn::ProxyBusObject& proxy,
+                                    const char* interface_name,
+                                    const ajn::MsgArg& changed,
+                                    const ajn::MsgArg& invalidated,
+                                    void* context);
+
+private:
+    // class composition
+    ajn::BusAttachment* bus_ptr_;
+    DeviceHandler* device_ptr_;
+    ServerHandler* server_ptr_;
+    // alljoyn properties
+    const char* interface_;
+    const char* server_interface_;
+};
+
+#endif // ALLJOYNTRANSPORT_HPP_INCLUDED
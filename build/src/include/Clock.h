@@ -0,0 +1,51 @@
+// Description:
+//      The clock classes are used by every time dependant part of the program
+//      instead of reading the wall clock directly. The system clock is used by
+//      default, but a virtual clock can be installed so the EventScheduler can
+//      move simulated time from one event to the next faster than real-time.
+//
+// Example:
+// time_t utc = Clock::Get ()->Now ();
+
+#ifndef CLOCK_H_INCLUDED
+#define CLOCK_H_INCLUDED
+
+// INCLUDES
+#include <ctime>
+#include <atomic>
+
+class Clock {
+public:
+    // constructor / destructor
+    virtual ~Clock ();
+    virtual unsigned long long Milliseconds () = 0;  // since the unix epoch
+    time_t Now ();                                   // seconds since epoch
+
+    // the clock used by the program, defaults to the system clock
+    static Clock* Get ();
+    static void Set (Clock* clock_ptr);
+
+private:
+    static std::atomic <Clock*> clock_ptr_;
+};  // end Clock
+
+// System Clock
+// - real-time wall clock
+class SystemClock : public Clock {
+public:
+    virtual unsigned long long Milliseconds ();
+};  // end System Clock
+
+// Virtual Clock
+// - simulated clock that only moves when it is told to
+class VirtualClock : public Clock {
+public:
+    VirtualClock (unsigned long long milliseconds);
+    virtual unsigned long long Milliseconds ();
+    void SetMilliseconds (unsigned long long milliseconds);
+
+private:
+    std::atomic <unsigned long long> milliseconds_;
+};  // end Virtual Clock
+
+#endif // CLOCK_H_INCLUDED
@@ -9,18 +9,34 @@
 
 // INCLUDES
 #include <string>
+#include <vector>
 #include "DistributedEnergyResource.h"
+#include "Operator.h"
+#include "TelemetryPublisher.h"
+#include "Executor.h"
+#include "Fleet.h"
 
 class CommandLineInterface {
     public:
         // constructor / destructor
-        CommandLineInterface (DistributedEnergyResource* der_ptr);
+        CommandLineInterface (DistributedEnergyResource* der_ptr,
+                              Operator* oper_ptr,
+                              TelemetryPublisher* publisher_ptr,
+                              Executor* executor_ptr,
+                              Fleet* fleet_ptr);
         virtual ~CommandLineInterface ();
         void Help ();
         bool Control (const std::string& input);
 
+    private:
+        void FleetControl (const std::vector <std::string>& tokens);
+
     private:
         DistributedEnergyResource* der_ptr_;
+        Operator* oper_ptr_;
+        TelemetryPublisher* publisher_ptr_;
+        Executor* executor_ptr_;
+        Fleet* fleet_ptr_;      // NULL when the fleet is disabled
 
 };  // end Command Line Interface
 
@@ -0,0 +1,47 @@
+// Description:
+//      The executor tasks of the control path. main and LoopbackBench both add
+//      them from here so the bench measures the same loops the program runs.
+//      The resource task sleeps until its next predicted event and runs at the
+//      device period while the power ramps, commands wake it right away. The
+//      device task sends the telemetry at the device period. NextStep () is
+//      the sleep of the resource task for programs that step it themselves.
+//
+// Example:
+// control_tasks::WakeOnCommand (&executor, &der);
+// control_tasks::AddResource (&executor, &der, &publisher, 500, 60000);
+// control_tasks::AddDevice (&executor, &sgd, 500);
+
+#ifndef CONTROLTASKS_H_INCLUDED
+#define CONTROLTASKS_H_INCLUDED
+
+// INCLUDES
+#include <functional>
+#include "DistributedEnergyResource.h"
+#include "Executor.h"
+#include "SmartGridDevice.h"
+#include "TelemetryPublisher.h"
+
+namespace control_tasks {
+
+// called on the executor thread with the snapshot after each resource loop
+typedef std::function <void (const DistributedEnergyResource::Snapshot&)>
+    SnapshotObserver;
+
+void WakeOnCommand (Executor* executor_ptr,
+                    DistributedEnergyResource* der_ptr);
+double NextStep (DistributedEnergyResource* der_ptr,
+                 TelemetryPublisher* publisher_ptr,
+                 unsigned int period);
+void AddResource (Executor* executor_ptr,
+                  DistributedEnergyResource* der_ptr,
+                  TelemetryPublisher* publisher_ptr,
+                  unsigned int period,
+                  unsigned int max_sleep,
+                  SnapshotObserver observer = nullptr);
+void AddDevice (Executor* executor_ptr,
+                SmartGridDevice* sgd_ptr,
+                unsigned int period);
+
+}  // end control_tasks
+
+#endif // CONTROLTASKS_H_INCLUDED
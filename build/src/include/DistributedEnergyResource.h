@@ -5,12 +5,29 @@
 //      this class all the other class that will used the BESS, EWH, and PV will
 //      only need to take a DER as an argument. The DER class also serves as a
 //      simple simulator for der interactions using AllJoyn.
+//
+//      Loop () runs on the control thread. Other threads change setpoints with
+//      the Queue methods, which are applied after the physics of the next
+//      Loop (). Each kind of setpoint (power, price, remote time) keeps only
+//      the latest value queued, so a burst of commands can never be lost to a
+//      full queue. Other threads read properties with GetSnapshot (), which
+//      is published at the end of each Loop (). The Set and Get methods are
+//      for the control thread.
+//
+//      Power ramps linearly to its setpoint, so the energy moved in a Loop ()
+//      is integrated exactly for any delta_time, including a ramp that reaches
+//      its setpoint or an energy limit part way through. NextEvent () predicts
+//      when the next of those changes happens so the control loop can sleep
+//      until then instead of polling.
 
 #ifndef DISTRIBUTEDENERGYRESOURCE_H_INCLUDED
 #define DISTRIBUTEDENERGYRESOURCE_H_INCLUDED
 
 #include <string>
 #include <map>
+#include <functional>
+#include "SetpointSlot.h"
+#include "SeqLock.h"
 
 class DistributedEnergyResource {
     public:
@@ -21,12 +38,47 @@ class DistributedEnergyResource {
         virtual void Loop (float delta_time);
         virtual void Display ();
 
+    public:
+        // consistent view of every property for other threads
+        struct Snapshot {
+            unsigned int rated_export_power;
+            unsigned int rated_export_energy;
+            unsigned int export_ramp;
+            unsigned int rated_import_power;
+            unsigned int rated_import_energy;
+            unsigned int import_ramp;
+            unsigned int idle_losses;
+            float export_power;
+            float export_energy;
+            float import_power;
+            float import_energy;
+            unsigned int export_watts;
+            unsigned int import_watts;
+            unsigned int remote_utc;
+            float price;
+        };
+        Snapshot GetSnapshot ();
+
+        // setpoint commands from other threads, the last one of a kind wins
+        void QueueImportWatts (unsigned int power);
+        void QueueExportWatts (unsigned int power);
+        void QueuePrice (float price);
+        void QueueRemoteTime (unsigned int utc);
+        // called after every queued command, set before other threads queue
+        void SetCommandNotify (std::function <void ()> notify);
+
+    public:
+        // event prediction (ms) at the current setpoints
+        double NextEvent ();
+        double TimeToTransfer (double watt_hours);
+        bool IsRamping ();
+
     public:
         // accessor methods
         // export
         void SetExportWatts (unsigned int power);
         void SetExportPower (float power);
-        void SetExportEnergy (float energy);
+        void SetExportEnergy (double energy);
         void SetRatedExportPower (unsigned int watts);
         void SetRatedExportEnergy (unsigned int watt_hours);
         void SetExportRamp (unsigned int watts_per_second);
@@ -39,7 +91,7 @@ class DistributedEnergyResource {
         // import
         void SetImportWatts (unsigned int power);
         void SetImportPower (float power);
-        void SetImportEnergy (float energy);
+        void SetImportEnergy (double energy);
         void SetRatedImportPower (unsigned int watts);
         void SetRatedImportEnergy (unsigned int watt_hours);
         void SetImportRamp (unsigned int watts_per_second);
@@ -71,6 +123,17 @@ class DistributedEnergyResource {
         virtual void ExportPower ();
         virtual void IdleLoss ();
         virtual void Log ();
+        // thread hand off
+        void ApplyCommands ();
+        void Publish ();
+
+    private:
+        // tags of the power setpoint, import and export replace each other
+        enum Direction : unsigned char {
+            IMPORT,
+            EXPORT
+        };
+        void Notify ();
 
     private:       
         // rated export
@@ -85,9 +148,9 @@ class DistributedEnergyResource {
         unsigned int idle_losses_;              // (Wh h^-1)
         // dynamic properties
         float export_power_;
-        float export_energy_;
+        double export_energy_;  // double so small ticks do not lose energy
         float import_power_;
-        float import_energy_;
+        double import_energy_;
         // control properties
         unsigned int export_watts_;
         unsigned int import_watts_;
@@ -98,6 +161,13 @@ class DistributedEnergyResource {
         unsigned int last_utc_;  // used to prevent multiple logs per cycle
         unsigned int log_inc_;
         std::string log_path_;
+        bool log_binary_;  // compact binary records instead of text lines
+        // thread hand off
+        SetpointSlot power_command_;
+        SetpointSlot price_command_;    // float bits
+        SetpointSlot time_command_;
+        SeqLock <Snapshot> snapshot_;
+        std::function <void ()> notify_;
 };
 
 #endif // DISTRIBUTEDENERGYRESOURCE_H_INCLUDED
@@ -0,0 +1,66 @@
+// Description:
+//      This class is a discrete-event scheduler. Events are stored in time
+//      order and Run () moves a virtual clock directly from one event to the
+//      next, so hours of simulated time can be processed in seconds. Events
+//      scheduled for the same time run in the order they were scheduled.
+//
+// Example:
+// VirtualClock clock (0);
+// EventScheduler scheduler (&clock);
+// scheduler.Every (0, 500, [&] () { der_ptr->Loop (500); });
+// scheduler.Run (24*60*60*1000);
+
+#ifndef EVENTSCHEDULER_H_INCLUDED
+#define EVENTSCHEDULER_H_INCLUDED
+
+// INCLUDES
+#include <functional>
+#include <queue>
+#include <vector>
+#include "Clock.h"
+
+class EventScheduler {
+public:
+    // constructor / destructor
+    EventScheduler (VirtualClock* clock_ptr);
+    virtual ~EventScheduler ();
+    void At (unsigned long long time, std::function <void ()> event);
+    void Every (unsigned long long start,
+                unsigned long long period,
+                std::function <void ()> event);
+    void Run (unsigned long long end);
+
+public:
+    // accessor methods
+    unsigned long long GetEventCount ();
+    unsigned long long GetTime ();
+
+private:
+    struct Event {
+        unsigned long long time;        // (ms) since epoch
+        unsigned long long sequence;    // tie breaker for equal times
+        std::function <void ()> action;
+
+        Event (unsigned long long time,
+               unsigned long long sequence,
+               std::function <void ()> action)
+            : time(time), sequence(sequence), action(action) {
+        };
+
+        // std::priority_queue keeps the largest element on top
+        bool operator < (const Event& rhs) const {
+            if (time != rhs.time) {
+                return time > rhs.time;
+            }
+            return sequence > rhs.sequence;
+        };
+    };
+
+private:
+    VirtualClock* clock_ptr_;
+    unsigned long long sequence_;
+    unsigned long long event_count_;
+    std::priority_queue <Event> events_;
+};  // end EventScheduler
+
+#endif // EVENTSCHEDULER_H_INCLUDED
@@ -0,0 +1,90 @@
+// Description:
+//      This class runs periodic tasks on a single thread. Each task has its own
+//      period and an absolute deadline on the monotonic clock, and the thread
+//      sleeps until the earliest deadline so the periods do not drift with the
+//      run time of the tasks. A task that runs past one or more of its
+//      deadlines skips them and the skipped periods are counted as overruns.
+//      The start jitter and execution time of every task are kept in
+//      histograms (microseconds) that Display () prints.
+//
+//      An adaptive task returns the milliseconds until it should run again,
+//      so it can sleep until its next predicted event. Wake () runs every
+//      adaptive task as soon as possible, for example when a command arrives.
+//
+// Example:
+// Executor executor;
+// executor.Every ("fleet", 500, [&] (float delta) { fleet.Loop (delta); });
+// executor.Adaptive ("resource", 1, 60000, [&] (float delta) {
+//     der.Loop (delta);
+//     return der.NextEvent ();
+// });
+// thread exec (&Executor::Run, &executor);
+// executor.Stop ();
+// exec.join ();
+
+#ifndef EXECUTOR_H_INCLUDED
+#define EXECUTOR_H_INCLUDED
+
+// INCLUDES
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "Histogram.h"
+
+class Executor {
+public:
+    // the task is passed the milliseconds since its last run started
+    typedef std::function <void (float delta_time)> Function;
+    // an adaptive task returns the milliseconds until its next run
+    typedef std::function <double (float delta_time)> AdaptiveFunction;
+
+public:
+    // constructor / destructor
+    Executor ();
+    virtual ~Executor ();
+    void Every (const std::string& name,
+                unsigned int period,
+                Function function);
+    void Adaptive (const std::string& name,
+                   unsigned int minimum,
+                   unsigned int maximum,
+                   AdaptiveFunction function);
+    void Run ();
+    void Stop ();
+    void Wake ();
+    void Display ();
+
+private:
+    typedef std::chrono::steady_clock SteadyClock;
+
+    struct Task {
+        std::string name;
+        SteadyClock::duration period;     // maximum period if adaptive
+        SteadyClock::duration minimum;    // minimum period if adaptive
+        SteadyClock::time_point deadline;
+        SteadyClock::time_point last_start;
+        Function function;
+        AdaptiveFunction adaptive;          // set for adaptive tasks only
+        Histogram jitter;       // (us) late start after the deadline
+        Histogram execution;    // (us) run time of the function
+        std::atomic <unsigned long long> overruns;  // skipped deadlines
+    };
+
+private:
+    Task* Next ();
+    void Execute (Task* task_ptr);
+
+private:
+    std::vector <std::unique_ptr <Task>> tasks_;   // fixed once Run () starts
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_;
+    bool woken_;
+};  // end Executor
+
+#endif // EXECUTOR_H_INCLUDED
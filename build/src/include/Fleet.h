@@ -0,0 +1,115 @@
+// Description:
+//      This class simulates many distributed energy resources in a single
+//      process. Rated values, control setpoints and energy state for every
+//      unit are kept in structure-of-arrays buffers so the Loop () method can
+//      step the whole fleet with one branch-free kernel the compiler is able
+//      to vectorize. Units are initialized from the [DER] config section and
+//      each unit (n) can override any [DER] property in a [DER.n] section.
+//
+//      Loop () and the Set methods run on the control thread. Other threads
+//      change setpoints with the Queue methods, the last command for a unit
+//      wins and is applied after the physics of the next Loop (), and read the
+//      fleet totals with GetSnapshot (), which is published by every Loop ().
+
+#ifndef FLEET_H_INCLUDED
+#define FLEET_H_INCLUDED
+
+// INCLUDES
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include "tsu.h"
+#include "SeqLock.h"
+#include "SetpointSlot.h"
+
+class Fleet {
+    public:
+        // constructor / destructor
+        Fleet (tsu::config_map& configs);
+        Fleet (std::map <std::string, std::string> init, unsigned int units);
+        virtual ~Fleet ();
+        void Loop (float delta_time);
+        void Display (unsigned int unit);
+
+    public:
+        // totals of every unit for other threads
+        struct Snapshot {
+            unsigned int units;
+            unsigned int importing;     // units with an import setpoint
+            unsigned int exporting;     // units with an export setpoint
+            float import_power;
+            double import_energy;
+            float export_power;
+            double export_energy;
+        };
+        Snapshot GetSnapshot ();
+        void Display ();
+
+        // setpoint commands from other threads, the last one for a unit wins
+        void QueueImportWatts (unsigned int unit, unsigned int power);
+        void QueueExportWatts (unsigned int unit, unsigned int power);
+
+    public:
+        // accessor methods
+        unsigned int GetUnits ();
+        // export
+        void SetExportWatts (unsigned int unit, unsigned int power);
+        unsigned int GetExportWatts (unsigned int unit);
+        unsigned int GetRatedExportPower (unsigned int unit);
+        unsigned int GetExportPower (unsigned int unit);
+        unsigned int GetRatedExportEnergy (unsigned int unit);
+        unsigned int GetExportEnergy (unsigned int unit);
+        unsigned int GetExportRamp (unsigned int unit);
+        // import
+        void SetImportWatts (unsigned int unit, unsigned int power);
+        unsigned int GetImportWatts (unsigned int unit);
+        unsigned int GetRatedImportPower (unsigned int unit);
+        unsigned int GetImportPower (unsigned int unit);
+        unsigned int GetRatedImportEnergy (unsigned int unit);
+        unsigned int GetImportEnergy (unsigned int unit);
+        unsigned int GetImportRamp (unsigned int unit);
+        // idle
+        unsigned int GetIdleLosses (unsigned int unit);
+
+    private:
+        void Initialize (std::map <std::string, std::string> init,
+                         unsigned int unit);
+        void ApplyCommands ();
+        void Publish ();
+
+    private:
+        // tags of a unit's power setpoint
+        enum Direction : unsigned char {
+            IMPORT,
+            EXPORT
+        };
+
+    private:
+        unsigned int units_;
+        // rated properties (stored as float so the kernel does no conversions)
+        std::vector <float> rated_export_power_;    // (W) to grid
+        std::vector <float> rated_export_energy_;   // (Wh)
+        std::vector <float> export_ramp_;           // (W s^-1)
+        std::vector <float> rated_import_power_;    // (W) from grid
+        std::vector <float> rated_import_energy_;   // (Wh)
+        std::vector <float> import_ramp_;           // (W s^-1)
+        std::vector <float> idle_losses_;           // (Wh h^-1)
+        // dynamic properties, energy is double like the DER so small ticks
+        // do not lose energy to rounding
+        std::vector <float> export_power_;
+        std::vector <double> export_energy_;
+        std::vector <float> import_power_;
+        std::vector <double> import_energy_;
+        // control properties
+        std::vector <float> export_watts_;
+        std::vector <float> import_watts_;
+        // scratch buffer for energy moved during a Loop () call
+        std::vector <float> watt_hours_;
+        // thread hand off
+        std::vector <SetpointSlot> commands_;
+        std::atomic <bool> pending_;    // a command was stored in commands_
+        SeqLock <Snapshot> snapshot_;
+};  // end Fleet
+
+#endif // FLEET_H_INCLUDED
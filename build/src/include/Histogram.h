@@ -0,0 +1,99 @@
+// Description:
+//      Fixed size histogram for latency style values. Values below 16 get their
+//      own bucket and every power of two above that is split into 8 buckets,
+//      so a percentile is within 12.5% of the recorded value. One thread
+//      records while any thread reads, the buckets are relaxed atomics.
+//
+// Example:
+// Histogram jitter;
+// jitter.Record (micros);
+// unsigned long long p99 = jitter.Percentile (0.99);
+
+#ifndef HISTOGRAM_H_INCLUDED
+#define HISTOGRAM_H_INCLUDED
+
+// INCLUDES
+#include <atomic>
+#include <cstddef>
+
+class Histogram {
+public:
+    Histogram () : count_(0), max_(0) {
+        for (size_t i = 0; i < kBuckets; i++) {
+            buckets_[i] = 0;
+        }
+    };
+
+    // Record
+    // - only one thread may call Record ()
+    void Record (unsigned long long value) {
+        buckets_[Histogram::Bucket (value)].fetch_add (
+            1, std::memory_order_relaxed);
+        count_.fetch_add (1, std::memory_order_relaxed);
+        if (value > max_.load (std::memory_order_relaxed)) {
+            max_.store (value, std::memory_order_relaxed);
+        }
+    };
+
+    // Percentile
+    // - upper bound of the bucket that holds the (p) fraction of values
+    unsigned long long Percentile (double p) const {
+        unsigned long long count = count_.load (std::memory_order_relaxed);
+        if (count == 0) {
+            return 0;
+        }
+        unsigned long long rank = (unsigned long long)(p * count);
+        if (rank >= count) {
+            rank = count - 1;
+        }
+        unsigned long long seen = 0;
+        for (size_t i = 0; i < kBuckets; i++) {
+            seen += buckets_[i].load (std::memory_order_relaxed);
+            if (seen > rank) {
+                unsigned long long upper = Histogram::Upper (i);
+                unsigned long long max = Histogram::Max ();
+                return upper < max ? upper : max;
+            }
+        }
+        return Histogram::Max ();
+    };
+
+    unsigned long long Count () const {
+        return count_.load (std::memory_order_relaxed);
+    };
+
+    unsigned long long Max () const {
+        return max_.load (std::memory_order_relaxed);
+    };
+
+private:
+    static const size_t kLinear = 16;   // values with their own bucket
+    static const size_t kSub = 8;       // buckets per power of two
+    static const size_t kBuckets = kLinear + (64 - 4) * kSub;
+
+    static size_t Bucket (unsigned long long value) {
+        if (value < kLinear) {
+            return value;
+        }
+        size_t exponent = 63 - __builtin_clzll (value);    // >= 4
+        size_t sub = (value >> (exponent - 3)) & (kSub - 1);
+        return kLinear + (exponent - 4) * kSub + sub;
+    };
+
+    static unsigned long long Upper (size_t bucket) {
+        if (bucket < kLinear) {
+            return bucket;
+        }
+        size_t exponent = (bucket - kLinear) / kSub + 4;
+        size_t sub = (bucket - kLinear) % kSub;
+        unsigned long long width = 1ULL << (exponent - 3);
+        return (1ULL << exponent) + (sub + 1) * width - 1;
+    };
+
+private:
+    std::atomic <unsigned long long> buckets_[kBuckets];
+    std::atomic <unsigned long long> count_;
+    std::atomic <unsigned long long> max_;
+};  // end Histogram
+
+#endif // HISTOGRAM_H_INCLUDED
@@ -0,0 +1,137 @@
+// Description:
+// 		This class owns the log files for the whole program. Callers push fixed
+// 		size records into a preallocated lock-free ring buffer and a background
+// 		thread writes them in batches to files that stay open until the date
+// 		changes. The thread sleeps without a timeout while the buffer is empty,
+// 		the first record of a batch starts a short wait for more records and
+// 		a buffer that is half full is written right away. The thread sleeps on
+// 		a semaphore and records how it sleeps in an atomic, the producer that
+// 		ends the sleep posts once so producers never lock. Text records produce
+// 		the same tab separated lines the Logger has always written, telemetry
+// 		records are written in a compact binary format that ConvertTelemetry ()
+// 		turns back into the text layout.
+//
+// Example:
+// LogWriter::Get ().Push ("DER_Data", path, telemetry);
+// LogWriter::Get ().Display ();
+
+#ifndef LOGWRITER_H_INCLUDED
+#define LOGWRITER_H_INCLUDED
+
+// INCLUDES
+#include <cstdio>
+#include <string>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <ostream>
+#include <semaphore.h>
+#include "RingBuffer.h"
+
+// Log Record
+// - a preformatted log line or binary record and its destination
+struct LogRecord {
+	enum Format : unsigned char {
+		TEXT,		// <path><context>_<date>.log
+		BINARY		// <path><context>_<date>.bin
+	};
+
+	Format format;
+	unsigned short size;
+	unsigned long long utc_ms;
+	char context[32];
+	char path[128];
+	char data[256];
+	bool truncated = false;		// the data did not fit and was cut off
+
+	void SetDestination (const std::string& context, const std::string& path);
+	// true if the data had to be truncated
+	bool SetData (const std::string& text);
+	bool SetData (const void* bytes, size_t count);
+};
+
+// Telemetry Record
+// - binary layout of a DER_Data log line
+struct TelemetryRecord {
+	unsigned long long utc_ms;
+	unsigned int import_watts;
+	float import_power;
+	float import_energy;
+	unsigned int export_watts;
+	float export_power;
+	float export_energy;
+};
+
+class LogWriter {
+public:
+	// the program has a single writer
+	static LogWriter& Get ();
+	virtual ~LogWriter ();
+
+	bool Push (const LogRecord& record);
+	bool Push (const std::string& context,
+			   const std::string& path,
+			   const TelemetryRecord& telemetry);
+	void SetBlocking (bool blocking);
+	void Flush ();
+	void Stop ();
+	void Display ();
+
+	// counters
+	unsigned long long GetWritten ();
+	unsigned long long GetDropped ();
+	unsigned long long GetOverflows ();
+	unsigned long long GetTruncated ();
+	unsigned long long GetBatches ();
+
+	// convert a binary telemetry file to the DER_Data text layout
+	static bool ConvertTelemetry (const std::string& filename,
+								  std::ostream& output);
+
+private:
+	LogWriter (size_t capacity, unsigned int interval);
+	void Loop ();
+	void Wake ();
+	void Sleep (int state);
+	void Write (const LogRecord& record);
+	void Close ();
+	static std::string FormatTelemetry (const TelemetryRecord& telemetry,
+										const char* date_time);
+
+private:
+	struct File {
+		std::string date;
+		std::FILE* file = NULL;
+	};
+
+	// how the writer thread sleeps
+	enum SleepState {
+		AWAKE,
+		IDLE,		// any record or Wake () ends the sleep
+		BATCH		// only Wake () ends the sleep before (interval_)
+	};
+
+private:
+	RingBuffer <LogRecord> ring_;
+	unsigned int interval_;				// (ms) a batch waits to fill
+	std::map <std::string, File> files_;
+	std::thread thread_;
+	sem_t semaphore_;					// posted once per ended sleep
+	std::atomic <int> asleep_;			// SleepState, cleared by the poster
+	std::atomic <bool> done_;
+	std::atomic <bool> wake_;			// write now
+	std::atomic <bool> blocking_;		// wait instead of drop when full
+	// counters
+	std::atomic <unsigned long long> pushed_;
+	std::atomic <unsigned long long> written_;
+	std::atomic <unsigned long long> dropped_;
+	std::atomic <unsigned long long> overflows_;
+	std::atomic <unsigned long long> truncated_;
+	std::atomic <unsigned long long> batches_;
+	// date strings are only formatted once per second
+	time_t last_second_;
+	char date_[16];
+	char date_time_[32];
+};
+
+#endif // LOGWRITER_H_INCLUDED
@@ -0,0 +1,91 @@
+// Description:
+//      In-process transport for running the control path without a bus. The
+//      server side calls ImportPower (), ExportPower (), ChangePrice () and
+//      ChangeTime () from any thread, and the messages are queued and delivered
+//      in order to the handlers by the thread that calls Run (), the way the
+//      AllJoyn dispatcher delivers method calls. EmitPropertiesChanged ()
+//      passes the names and values to the properties listener on the emitting
+//      thread. The time from queueing a message to its delivery is kept in a
+//      histogram (ns).
+//
+// Example:
+// LoopbackTransport loopback;
+// SmartGridDevice sgd (der_ptr, publisher_ptr, &loopback);
+// loopback.SetPropertiesListener ([] (const char** props,
+//                                     const unsigned int* values,
+//                                     size_t count) { ... });
+// thread dispatch (&LoopbackTransport::Run, &loopback);
+// loopback.ImportPower (3000);
+// loopback.Stop ();
+// dispatch.join ();
+
+#ifndef LOOPBACKTRANSPORT_H_INCLUDED
+#define LOOPBACKTRANSPORT_H_INCLUDED
+
+// INCLUDES
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "Histogram.h"
+#include "Transport.h"
+
+class LoopbackTransport : public Transport {
+public:
+    // the server is passed the names and values of the changed properties
+    typedef std::function <void (const char** props,
+                                 const unsigned int* values,
+                                 size_t count)> PropertiesListener;
+
+public:
+    // constructor / destructor
+    LoopbackTransport ();
+    virtual ~LoopbackTransport ();
+    void SetDeviceHandler (DeviceHandler* handler_ptr);
+    void SetServerHandler (ServerHandler* handler_ptr);
+    bool EmitPropertiesChanged (const char** props,
+                                const unsigned int* values,
+                                size_t count);
+
+    // server side, safe to call from any thread
+    void SetPropertiesListener (PropertiesListener listener);
+    void ImportPower (unsigned int watts);
+    void ExportPower (unsigned int watts);
+    void ChangePrice (int price);
+    void ChangeTime (unsigned int utc);
+
+    // dispatch
+    void Run ();
+    void Stop ();
+    const Histogram& GetLatency () const;
+    unsigned long long GetDelivered () const;
+
+private:
+    typedef std::chrono::steady_clock SteadyClock;
+
+    struct Message {
+        enum Type {IMPORT_POWER, EXPORT_POWER, PRICE, TIME};
+        Type type;
+        unsigned int value;
+        SteadyClock::time_point sent;
+    };
+
+private:
+    void Send (Message::Type type, unsigned int value);
+    void Deliver (const Message& message);
+
+private:
+    DeviceHandler* device_ptr_;
+    ServerHandler* server_ptr_;
+    PropertiesListener listener_;
+    std::deque <Message> messages_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_;
+    Histogram latency_;     // (ns) queued until delivered
+    std::atomic <unsigned long long> delivered_;
+};  // end LoopbackTransport
+
+#endif // LOOPBACKTRANSPORT_H_INCLUDED
@@ -2,7 +2,10 @@
 // Description:
 //      This class is used to automatically control a der object using a
 //      predetermined schedule. The schedule has a known format so the operator
-//      used the ScheduleHeader structure to store the information
+//      used the ScheduleHeader structure to store the information. The file is
+//      compiled into a table sorted by time of day and a cursor points to the
+//      next row that is due, so each Loop () only looks at rows it dispatches.
+//      A new schedule can be swapped in with Reload () while the loop runs.
 
 #ifndef OPERATOR_H_INCLUDED
 #define OPERATOR_H_INCLUDED
@@ -10,6 +13,7 @@
 // INCLUDES
 #include <string>
 #include <vector>
+#include <memory>
 #include "DistributedEnergyResource.h"
 
 class Operator {
@@ -17,24 +21,42 @@ public:
     Operator (const std::string& filename, DistributedEnergyResource* der_ptr);
     virtual ~Operator ();
     void Loop ();
+    void Pause ();
+    bool Reload (const std::string& filename);
+    unsigned int NextEventTime (unsigned int utc);
 
 private:
+    enum Control : unsigned char {
+        IDLE,
+        IMPORT,
+        EXPORT
+    };
+
     // since the file columns are known we can create and object to represent
-    // the values within the column.
+    // the values within the column. The time is stored as seconds of the day.
     struct ScheduleHeader {
         unsigned int time;
-        std::string control;
+        Control control;
         unsigned int setting;
-
-        ScheduleHeader (int time, std::string control, unsigned int setting)
-            : time(time), control(control), setting(setting) {
-        };
     };
 
+    typedef std::vector <ScheduleHeader> Schedule;
+
+private:
+    static std::shared_ptr <const Schedule> Compile (
+        const std::string& filename
+    );
+    void Seek (unsigned int utc);
+    void Dispatch (const ScheduleHeader& row);
+
 private:
-    unsigned int index_;
     DistributedEnergyResource* der_ptr_;
-    std::vector <ScheduleHeader> schedule_;
+    // the latest compiled schedule, only accessed with std::atomic_load/store
+    std::shared_ptr <const Schedule> schedule_;
+    // the schedule the cursor belongs to, only used by Loop ()
+    std::shared_ptr <const Schedule> active_;
+    unsigned int cursor_;       // index of the next row that is due
+    unsigned int last_utc_;     // last time Loop () ran
 };  // end Operator
 
-#endif // OPERATOR_H_INCLUDED
\ No newline at end of file
+#endif // OPERATOR_H_INCLUDED
@@ -0,0 +1,119 @@
+// Description:
+//      Bounded lock-free queue that any number of threads can push to and
+//      pop from. All memory is allocated by the constructor so Push () and
+//      Pop () never allocate and never block; Push () returns false when the
+//      buffer is full. Each cell carries a sequence number that tells a thread
+//      whether the cell is ready to be written or read.
+//      - reference:
+//      http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//
+// Example:
+// RingBuffer <int> ring (1024);
+// ring.Push (1);
+// int value;
+// while (ring.Pop (value)) { ... }
+
+#ifndef RINGBUFFER_H_INCLUDED
+#define RINGBUFFER_H_INCLUDED
+
+// INCLUDES
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T>
+class RingBuffer {
+public:
+    // the capacity is rounded up to a power of two
+    RingBuffer (size_t capacity) : enqueue_pos_(0), dequeue_pos_(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        cells_.reset (new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            cells_[i].sequence.store (i, std::memory_order_relaxed);
+        }
+    };
+
+    // Push
+    // - copy the item into the buffer, false if the buffer is full
+    bool Push (const T& item) {
+        Cell* cell;
+        size_t pos = enqueue_pos_.load (std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load (std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak (
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load (std::memory_order_relaxed);
+            }
+        }
+        cell->data = item;
+        cell->sequence.store (pos + 1, std::memory_order_release);
+        return true;
+    };
+
+    // Pop
+    // - copy the oldest item out of the buffer, false if the buffer is empty
+    bool Pop (T& item) {
+        Cell* cell;
+        size_t pos = dequeue_pos_.load (std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load (std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak (
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load (std::memory_order_relaxed);
+            }
+        }
+        item = cell->data;
+        cell->sequence.store (pos + mask_ + 1, std::memory_order_release);
+        return true;
+    };
+
+    // Size
+    // - approximate number of items in the buffer
+    size_t Size () {
+        size_t head = dequeue_pos_.load (std::memory_order_relaxed);
+        size_t tail = enqueue_pos_.load (std::memory_order_relaxed);
+        return (tail > head) ? tail - head : 0;
+    };
+
+    size_t Capacity () {
+        return mask_ + 1;
+    };
+
+private:
+    struct Cell {
+        std::atomic <size_t> sequence;
+        T data;
+    };
+
+private:
+    std::unique_ptr <Cell[]> cells_;
+    size_t mask_;
+    // padding keeps producers and consumers off each others cache line
+    char padding_[64];
+    std::atomic <size_t> enqueue_pos_;
+    char padding2_[64];
+    std::atomic <size_t> dequeue_pos_;
+};  // end RingBuffer
+
+#endif // RINGBUFFER_H_INCLUDED
@@ -0,0 +1,74 @@
+// Description:
+//      Sequence lock for a single writer and any number of readers. The writer
+//      never waits and readers retry until they copy the value without the
+//      writer changing it, so every Load () returns one consistent value. The
+//      value is stored as atomic words so the copy is not a data race.
+//      - reference:
+//      https://www.hpl.hp.com/techreports/2012/HPL-2012-68.pdf
+//
+// Example:
+// SeqLock <State> state;
+// state.Store (new_state);     // writer thread
+// State copy = state.Load ();  // any thread
+
+#ifndef SEQLOCK_H_INCLUDED
+#define SEQLOCK_H_INCLUDED
+
+// INCLUDES
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+    static_assert (std::is_trivially_copyable <T>::value,
+                   "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock () : sequence_(0) {
+        T value = T ();
+        SeqLock::Store (value);
+    };
+
+    // Store
+    // - only one thread may call Store ()
+    void Store (const T& value) {
+        uint64_t words[kWords] = {};
+        memcpy (words, &value, sizeof (T));
+
+        unsigned long sequence = sequence_.load (std::memory_order_relaxed);
+        sequence_.store (sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        for (size_t i = 0; i < kWords; i++) {
+            data_[i].store (words[i], std::memory_order_relaxed);
+        }
+        sequence_.store (sequence + 2, std::memory_order_release);
+    };
+
+    // Load
+    // - copy the latest value, retries while a Store () is in progress
+    T Load () const {
+        uint64_t words[kWords];
+        unsigned long before, after;
+        do {
+            before = sequence_.load (std::memory_order_acquire);
+            for (size_t i = 0; i < kWords; i++) {
+                words[i] = data_[i].load (std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence (std::memory_order_acquire);
+            after = sequence_.load (std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        memcpy (&value, words, sizeof (T));
+        return value;
+    };
+
+private:
+    static const size_t kWords = (sizeof (T) + 7) / 8;
+    std::atomic <unsigned long> sequence_;   // odd while a store is running
+    std::atomic <uint64_t> data_[kWords];
+};  // end SeqLock
+
+#endif // SEQLOCK_H_INCLUDED
@@ -24,43 +24,30 @@
 
 // Author: Tylor Slay
 // Description:
-//      This class is used to notify the der object of any changes to the server
+//      This class is used to notify the der object of any changes to the server.
+//      The property changes are carried by a Transport, ~ reference Transport.h
 
 #ifndef SERVERLISTENER_HPP_INCLUDED
 #define SERVERLISTENER_HPP_INCLUDED
 
-#include <alljoyn/ProxyBusObject.h>
-#include <alljoyn/BusAttachment.h>
-#include <alljoyn/Observer.h>
 #include "DistributedEnergyResource.h"
+#include "Transport.h"
 
-class ServerListener : public ajn::MessageReceiver,
-                       public ajn::Observer::Listener,
-                       public ajn::ProxyBusObject::PropertiesChangedListener {
-    static const char* props[];
-
+class ServerListener : public Transport::ServerHandler {
 public :
     // member functions
-    ServerListener (ajn::BusAttachment* bus,
-                    ajn::Observer* obs,
-                    DistributedEnergyResource* der_ptr,
-                    const char* server_name);
-    virtual void ObjectDiscovered (ajn::ProxyBusObject& proxy);
-    virtual void ObjectLost (ajn::ProxyBusObject& proxy);
-    virtual void PropertiesChanged (ajn::ProxyBusObject& proxy,
-                                    const char* interface_name,
-                                    const ajn::MsgArg& changed,
-                                    const ajn::MsgArg& invalidated,
-                                    void* context);
+    ServerListener (DistributedEnergyResource* der_ptr,
+                    Transport* transport_ptr,
+                    bool fake_hwclock);
+    virtual ~ServerListener ();
+    void PriceChanged (int price);
+    void TimeChanged (unsigned int utc);
 
 private :
     // member variables
-    ajn::BusAttachment* bus_ptr_;
-    ajn::Observer* obs_ptr_;
     DistributedEnergyResource* der_ptr_;
-    const char* server_interface_;
-    unsigned int time_;
-    int price_;
+    Transport* transport_ptr_;
+    bool fake_hwclock_;     // set the system clock from the server time
 };
 
 #endif // SERVERLISTENER_HPP_INCLUDED
@@ -0,0 +1,50 @@
+// Description:
+//      Last writer wins slot for a setpoint that any thread stores and one
+//      control thread takes. A new value replaces one that was not taken yet,
+//      so the newest setpoint is never the one that is dropped and Store ()
+//      never fails or waits. The 32 bit value is kept with a pending flag and
+//      an 8 bit tag in one atomic word, the tag tells the taker what kind of
+//      setpoint it is, for example import or export.
+//
+// Example:
+// SetpointSlot power;
+// power.Store (IMPORT, 3000);              // any thread
+// unsigned char tag;
+// unsigned int watts;
+// if (power.Take (tag, watts)) { ... }     // control thread
+
+#ifndef SETPOINTSLOT_H_INCLUDED
+#define SETPOINTSLOT_H_INCLUDED
+
+// INCLUDES
+#include <atomic>
+
+class SetpointSlot {
+public:
+    SetpointSlot () : slot_(0) {};
+
+    // Store
+    // - replace any setpoint that was not taken yet
+    void Store (unsigned char tag, unsigned int value) {
+        slot_.store (kPending | (unsigned long long)tag << 32 | value,
+                     std::memory_order_release);
+    };
+
+    // Take
+    // - the latest setpoint, false if none was stored since the last Take ()
+    bool Take (unsigned char& tag, unsigned int& value) {
+        unsigned long long slot = slot_.exchange (0, std::memory_order_acquire);
+        if (!(slot & kPending)) {
+            return false;
+        }
+        tag = (unsigned char)(slot >> 32);
+        value = (unsigned int)slot;
+        return true;
+    };
+
+private:
+    static const unsigned long long kPending = 1ULL << 63;
+    std::atomic <unsigned long long> slot_;
+};  // end SetpointSlot
+
+#endif // SETPOINTSLOT_H_INCLUDED
@@ -25,50 +25,44 @@
 // Author: Tylor Slay
 // Description:
 //      This class is used to handle control signals from the server as well as
-//      notify the server of property changes.
+//      notify the server of property changes. The messages are carried by a
+//      Transport, ~ reference Transport.h
 
 #ifndef SMARTGRIDDEVICE_HPP_INCLUDED
 #define SMARTGRIDDEVICE_HPP_INCLUDED
 
-#include <alljoyn/Status.h>
-#include <alljoyn/BusObject.h>
-#include <alljoyn/BusAttachment.h>
 #include "DistributedEnergyResource.h"
+#include "TelemetryPublisher.h"
+#include "Transport.h"
 
-class SmartGridDevice : public ajn::BusObject {
+class SmartGridDevice : public Transport::DeviceHandler {
 public:
     // member methods
     SmartGridDevice (DistributedEnergyResource* der_ptr,
-                     ajn::BusAttachment* bus_ptr, 
-                     const char* name, 
-                     const char* path
+                     TelemetryPublisher* publisher_ptr,
+                     Transport* transport_ptr
     );
-    void ImportPowerHandler (const ajn::InterfaceDescription::Member* member,
-                             ajn::Message& message
-    );
-    void ExportPowerHandler (const ajn::InterfaceDescription::Member* member,
-                             ajn::Message& message
-    );
-    QStatus Get (const char* interface, 
-                 const char* property, 
-                 ajn::MsgArg& value
-    );
-    QStatus SendPropertiesUpdate ();
+    virtual ~SmartGridDevice ();
+    void ImportPower (unsigned int watts);
+    void ExportPower (unsigned int watts);
+    bool Get (const char* property, unsigned int& value);
+    bool SendPropertiesUpdate ();
     void Loop ();
 
+private:
+    bool SendProperties (const DistributedEnergyResource::Snapshot& der,
+                         const char** props,
+                         size_t count
+    );
+
 private:
     // class composition
     DistributedEnergyResource* der_ptr_;
-    ajn::BusAttachment* bus_ptr_;
-    const ajn::InterfaceDescription::Member* signal_;
-    // alljoyn properties
-    const char* interface_;
-    const char* name_;
+    TelemetryPublisher* publisher_ptr_;
+    Transport* transport_ptr_;
 
     // control properties
     unsigned int last_telemetry_utc_;
-    unsigned int last_import_energy_;
-    unsigned int last_export_energy_;
 
 };
 
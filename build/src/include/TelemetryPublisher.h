@@ -0,0 +1,97 @@
+// Description:
+//      This class decides which SmartGridDevice properties need to be sent to
+//      the server. It remembers the last value sent for each property and
+//      marks a property dirty when it moves past both its absolute and its
+//      relative deadband. Dirty properties are coalesced so at most one
+//      message is sent per minimum interval and only the dirty properties are
+//      included, a forced poll is a heartbeat that sends every property. The
+//      values only count as sent once Commit () is told the message went out.
+//      A changed value that is not sent within an interval is counted once as
+//      a suppressed property and the interval as one suppressed message. The
+//      deadbands and interval are set in the [Telemetry] config section.
+//
+// Example:
+// const char* props[TelemetryPublisher::PROPERTIES];
+// size_t count = publisher.Poll (der_ptr->GetSnapshot (), now, false, props);
+// if (count > 0) { publisher.Commit (transport.EmitPropertiesChanged (...)); }
+
+#ifndef TELEMETRYPUBLISHER_H_INCLUDED
+#define TELEMETRYPUBLISHER_H_INCLUDED
+
+// INCLUDES
+#include <string>
+#include <map>
+#include <atomic>
+#include "DistributedEnergyResource.h"
+
+class TelemetryPublisher {
+public:
+    enum Property {
+        RATED_EXPORT_POWER,
+        EXPORT_POWER,
+        RATED_EXPORT_ENERGY,
+        EXPORT_ENERGY,
+        EXPORT_RAMP,
+        RATED_IMPORT_POWER,
+        IMPORT_POWER,
+        RATED_IMPORT_ENERGY,
+        IMPORT_ENERGY,
+        IMPORT_RAMP,
+        IDLE_LOSSES,
+        PROPERTIES  // number of properties
+    };
+    static const char* names[PROPERTIES];
+
+public:
+    // constructor / destructor
+    TelemetryPublisher (std::map <std::string, std::string> init);
+    virtual ~TelemetryPublisher ();
+    static int Find (const char* name);
+    static unsigned int Value (int property,
+                               const DistributedEnergyResource::Snapshot& der);
+    void Reset (const DistributedEnergyResource::Snapshot& der);
+    size_t Poll (const DistributedEnergyResource::Snapshot& der,
+                 unsigned long long time,
+                 bool force,
+                 const char** props);
+    void Commit (bool sent);
+    void MarkSent (int property, unsigned int value);
+    double EnergyMargin (const DistributedEnergyResource::Snapshot& der);
+    unsigned long long NextDue ();
+    void Display ();
+
+public:
+    // counters
+    unsigned long long GetMessagesSent ();
+    unsigned long long GetMessagesSuppressed ();
+    unsigned long long GetPropertiesSent ();
+    unsigned long long GetPropertiesSuppressed ();
+
+private:
+    struct Deadband {
+        float absolute;     // same units as the property
+        float relative;     // fraction of the last value sent
+    };
+
+private:
+    void CountSuppressed ();
+
+private:
+    Deadband deadbands_[PROPERTIES];
+    std::atomic <unsigned int> sent_[PROPERTIES];  // Get () may update these
+    bool dirty_[PROPERTIES];
+    bool changed_[PROPERTIES];          // not sent in the current interval
+    unsigned int polled_[PROPERTIES];   // values selected by the last Poll ()
+    bool selected_[PROPERTIES];
+    unsigned long long polled_time_;    // (ms) of the last Poll () that sends
+    unsigned long long min_interval_;   // (ms) between messages
+    unsigned long long last_message_;   // (ms) time of the last message
+    unsigned long long interval_start_; // (ms) start of the counted interval
+    // counters
+    std::atomic <unsigned long long> messages_sent_;
+    std::atomic <unsigned long long> messages_suppressed_;
+    std::atomic <unsigned long long> properties_sent_;
+    std::atomic <unsigned long long> properties_suppressed_;
+};  // end TelemetryPublisher
+
+#endif // TELEMETRYPUBLISHER_H_INCLUDED
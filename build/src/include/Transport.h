@@ -0,0 +1,57 @@
+// Description:
+//      The transport carries messages between this device and the DERAS
+//      server. SmartGridDevice and ServerListener only use this interface, so
+//      the same control path runs over the AllJoyn bus (AllJoynTransport) or
+//      in-process without a network (LoopbackTransport).
+//
+//      Server to device: the ImportPower and ExportPower method calls are
+//      passed to the DeviceHandler and the server's price and time property
+//      changes are passed to the ServerHandler. Device to server:
+//      EmitPropertiesChanged () signals the named properties with the values
+//      the device passes in, so every property in one signal comes from the
+//      same snapshot. DeviceHandler::Get () answers the server's reads.
+//
+// Example:
+// AllJoynTransport transport (bus_ptr, device_name, path, server_name);
+// SmartGridDevice sgd (der_ptr, publisher_ptr, &transport);
+// ServerListener listener (der_ptr, &transport, true);
+
+#ifndef TRANSPORT_H_INCLUDED
+#define TRANSPORT_H_INCLUDED
+
+// INCLUDES
+#include <cstddef>
+
+class Transport {
+public:
+    // messages from the server to this device
+    class DeviceHandler {
+    public:
+        virtual ~DeviceHandler () {};
+        virtual void ImportPower (unsigned int watts) = 0;
+        virtual void ExportPower (unsigned int watts) = 0;
+        // false if the property is unknown
+        virtual bool Get (const char* property, unsigned int& value) = 0;
+    };
+
+    // property changes published by the server
+    class ServerHandler {
+    public:
+        virtual ~ServerHandler () {};
+        // tenths of a cent per watt-hour
+        virtual void PriceChanged (int price) = 0;
+        virtual void TimeChanged (unsigned int utc) = 0;
+    };
+
+public:
+    virtual ~Transport () {};
+    // handlers are set before messages arrive and may be set to NULL
+    virtual void SetDeviceHandler (DeviceHandler* handler_ptr) = 0;
+    virtual void SetServerHandler (ServerHandler* handler_ptr) = 0;
+    // false if the signal was not sent
+    virtual bool EmitPropertiesChanged (const char** props,
+                                        const unsigned int* values,
+                                        size_t count) = 0;
+};  // end Transport
+
+#endif // TRANSPORT_H_INCLUDED
@@ -2,9 +2,10 @@
 // Description:
 // 		This class is used to simplify logging. It automatically loads the time
 // 		along with the context, path arguments and then passes all further args
-// 		using the (<<) operator.
+// 		using the (<<) operator. The destructor only pushes the record to the
+// 		LogWriter, the file is written by the LogWriter thread.
 //
-// Example: 
+// Example:
 // Logger("INFO") << "Data\t" << "More Data";
 
 #ifndef LOGGER_H_INCLUDED
@@ -13,6 +14,7 @@
 // INCLUDES
 #include <string>
 #include <sstream>
+#include "LogWriter.h"
 
 class Logger {
 public:
@@ -24,21 +26,13 @@ public:
 	template <typename T>
 	Logger& operator << (T rhs) {
 		// string stream is a simple way to convert any data type into a string
-	    std::ostringstream ss;
-	    ss << rhs;
-		msg_ += ss.str();
+		ss_ << rhs;
 		return *this;
 	};
 
 private:
-	std::string msg_;
-	std::string context_;
-	std::string path_;
-
-private:
-	void ToFile ();
-	std::string GetDate ();
-	std::string GetDateTime ();
+	std::ostringstream ss_;
+	LogRecord record_;
 };
 
 #endif // LOGGER_H_INCLUDED
@@ -12,9 +12,18 @@
 #include <fstream>
 #include <sstream>
 #include <string> // getline, stoi, stod
+#include <string_view>
+#include <charconv> // from_chars
+#include <stdexcept>
+#include <type_traits>
+#include <cstdlib>
+#include <cerrno>
 #include <vector>
-#include <regex>
 #include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 // Tylor Slay Utilities is used to map config.ini files as well store files as
@@ -34,7 +43,7 @@ typedef std::vector <std::vector <std::string>> string_matrix;
 // - the to_string () function in STL doesn't seem to work for all cases so I 
 // - made this function as a hack to be uniform
 template <typename T>
-static std::string ToString (T t_value) {
+inline std::string ToString (T t_value) {
 	std::ostringstream ss;
 	ss << t_value;
 	return ss.str();
@@ -43,7 +52,7 @@ static std::string ToString (T t_value) {
 // File To String
 // - this method reads the entire file into a single string.
 // - primarily used by FileToVector or FileToMatrix, but can be stand-alone
-static std::string FileToString (const std::string& kFilename) {
+inline std::string FileToString (const std::string& kFilename) {
 
 	// open file at end of file
 	if (std::ifstream file{kFilename, std::ios::binary | std::ios::ate}) {
@@ -56,48 +65,273 @@ static std::string FileToString (const std::string& kFilename) {
 			return str;
 		} catch (const std::exception& e) {
 			std::cout << "[ERROR]...reading file: " << e.what () << std::endl;
-			return NULL;
+			return std::string ();
 		}
 	} else {
 		std::cout << "[ERROR]...file not found!\n";
-		return NULL;
+		return std::string ();
  	}
 } // end File To String
 
+// Mapped File
+// - read only view of a whole file. The file is memory mapped so nothing is
+// - copied, files that can not be mapped (pipes, /proc) are read instead.
+class MappedFile {
+public:
+	explicit MappedFile (const std::string& kFilename)
+		: open_(false), data_(NULL), size_(0) {
+		int fd = open (kFilename.c_str (), O_RDONLY);
+		if (fd < 0) {
+			return;
+		}
+		open_ = true;
+		struct stat info;
+		if (fstat (fd, &info) == 0 && S_ISREG (info.st_mode)) {
+			size_ = info.st_size;
+			if (size_ > 0) {
+				void* data = mmap (NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data != MAP_FAILED) {
+					madvise (data, size_, MADV_SEQUENTIAL);
+					data_ = static_cast <char*> (data);
+				}
+			}
+		}
+		if (!data_) {
+			char chunk[4096];
+			ssize_t count;
+			while ((count = read (fd, chunk, sizeof (chunk))) > 0) {
+				buffer_.append (chunk, count);
+			}
+			size_ = buffer_.size ();
+		}
+		close (fd);
+	};
+
+	~MappedFile () {
+		if (data_) {
+			munmap (data_, size_);
+		}
+	};
+
+	MappedFile (const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	bool IsOpen () const {
+		return open_;
+	};
+
+	std::string_view View () const {
+		if (data_) {
+			return std::string_view (data_, size_);
+		}
+		return std::string_view (buffer_);
+	};
+
+private:
+	bool open_;
+	char* data_;
+	size_t size_;
+	std::string buffer_;
+};  // end MappedFile
+
+// Trim
+// - remove spaces, tabs and line endings from both ends
+inline std::string_view Trim (std::string_view text) {
+	const char* kSpace = " \t\r\n";
+	size_t first = text.find_first_not_of (kSpace);
+	if (first == std::string_view::npos) {
+		return std::string_view ();
+	}
+	size_t last = text.find_last_not_of (kSpace);
+	return text.substr (first, last - first + 1);
+} // end Trim
+
+// For Each Line
+// - call kFunction (line number, line) for each line of the text, the line
+// - number starts at 1 and the line does not include "\n" or "\r\n"
+template <typename Function>
+inline void ForEachLine (std::string_view text, Function kFunction) {
+	size_t number = 0;
+	while (!text.empty ()) {
+		size_t end = text.find ('\n');
+		std::string_view line = text.substr (0, end);
+		text.remove_prefix (end == std::string_view::npos ? text.size () : end + 1);
+		if (!line.empty () && line.back () == '\r') {
+			line.remove_suffix (1);
+		}
+		kFunction (++number, line);
+	}
+} // end For Each Line
+
+// Split View
+// - split a line at each delimiter into (cells), which point into the line
+inline void SplitView (std::string_view line,
+							  char kDelimiter,
+							  std::vector <std::string_view>& cells) {
+	cells.clear ();
+	size_t start = 0;
+	while (true) {
+		size_t end = line.find (kDelimiter, start);
+		if (end == std::string_view::npos) {
+			cells.push_back (line.substr (start));
+			return;
+		}
+		cells.push_back (line.substr (start, end - start));
+		start = end + 1;
+	}
+} // end Split View
+
+// Parse Number
+// - convert the whole text to a number in place, false if the text is empty,
+// - has trailing characters or is out of range for the type. Unsigned types
+// - do not accept a sign.
+template <typename T>
+inline bool ParseNumber (std::string_view text, T& value) {
+	static_assert (std::is_arithmetic <T>::value, "ParseNumber needs a number");
+	text = Trim (text);
+	if (!text.empty () && text.front () == '+') {
+		text.remove_prefix (1);
+	}
+	if (text.empty ()) {
+		return false;
+	}
+	const char* end = text.data () + text.size ();
+#ifndef __cpp_lib_to_chars
+	// older standard libraries only have from_chars for integers
+	if constexpr (std::is_floating_point <T>::value) {
+		std::string copy (text);
+		char* copy_end;
+		errno = 0;
+		long double number = std::strtold (copy.c_str (), &copy_end);
+		if (errno != 0 || copy_end != copy.c_str () + copy.size ()) {
+			return false;
+		}
+		value = static_cast <T> (number);
+		return true;
+	} else
+#endif
+	{
+		std::from_chars_result result = std::from_chars (text.data (), end, value);
+		return result.ec == std::errc () && result.ptr == end;
+	}
+} // end Parse Number
+
+// Parse CSV
+// - call kFunction (line number, cells) for every line with text. The cells
+// - point into the file and are only valid during the call. Returns false if
+// - the file can not be read.
+template <typename Function>
+inline bool ParseCSV (const std::string& kFilename,
+					  char kDelimiter,
+					  Function kFunction) {
+	MappedFile file (kFilename);
+	if (!file.IsOpen ()) {
+		std::cout << "[ERROR]...file not found: " << kFilename << "\n";
+		return false;
+	}
+	std::vector <std::string_view> cells;
+	ForEachLine (file.View (), [&] (size_t number, std::string_view line) {
+		if (Trim (line).empty ()) {
+			return;
+		}
+		SplitView (line, kDelimiter, cells);
+		kFunction (number, cells);
+	});
+	return true;
+} // end Parse CSV
+
 // Map Config File
-// - this method uses regular expressions to create a config map to
-// initialize class members or define program settings.
-// - https://en.wikipedia.org/wiki/Regular_expression
-static config_map MapConfigFile (const std::string& kFilename) {
-	// read file into a string
+// - this method maps each [section] and property=value line of an INI file.
+// - Blank lines and lines starting with # or ; are skipped, any other line is
+// - reported with its line number and ignored.
+// - https://en.wikipedia.org/wiki/INI_file
+inline config_map MapConfigFile (const std::string& kFilename) {
 	config_map file_map;
-	std::string file_string, line, section, property, value;
-	file_string = FileToString(kFilename);
+	MappedFile file (kFilename);
+	if (!file.IsOpen ()) {
+		std::cout << "[ERROR]...file not found: " << kFilename << "\n";
+		return file_map;
+	}
 
-	// create section and property regular expressions
-	std::regex section_regex("^\\[(.*)\\]");
-	std::regex property_regex("^(\\w+)=([^\\+]+(?!\\+{3}))");
-	std::smatch match_regex;
+	std::map <std::string, std::string>* section_ptr = &file_map[""];
+	ForEachLine (file.View (), [&] (size_t number, std::string_view line) {
+		std::string_view text = Trim (line);
+		if (text.empty () || text.front () == '#' || text.front () == ';') {
+			return;
+		}
 
-	// split long string by each new line
-	std::stringstream ss(file_string);
-	while (std::getline(ss, line)) {
 		// first look for section then property
-		if (std::regex_search(line, match_regex, section_regex)) {
-			section = match_regex[1];
-		} else if (std::regex_search(line, match_regex, property_regex)){
-			property = match_regex[1];
-			value = match_regex[2];
-			file_map[section][property] = value;
+		if (text.front () == '[') {
+			size_t end = text.find (']');
+			if (end != std::string_view::npos) {
+				section_ptr = &file_map[std::string (text.substr (1, end - 1))];
+				return;
+			}
+		} else {
+			size_t equal = text.find ('=');
+			if (equal != std::string_view::npos && equal > 0) {
+				std::string property (Trim (text.substr (0, equal)));
+				std::string value (Trim (text.substr (equal + 1)));
+				(*section_ptr)[property] = value;
+				return;
+			}
 		}
+		std::cout << "[ERROR]: " << kFilename << ":" << number
+			<< ": expected [section] or property=value\n";
+	});
+
+	// the unnamed section only exists if it has properties
+	if (file_map[""].empty ()) {
+		file_map.erase ("");
 	}
 	return file_map;
 } // end Map Config File
 
+// Get Config
+// - typed value of a [section] property. Throws std::invalid_argument naming
+// - the section and property if it is missing or not a valid number.
+template <typename T>
+inline T GetConfig (const config_map& kConfigs,
+					const std::string& kSection,
+					const std::string& kProperty) {
+	auto section = kConfigs.find (kSection);
+	if (section != kConfigs.end ()) {
+		auto property = section->second.find (kProperty);
+		if (property != section->second.end ()) {
+			T value;
+			if (!ParseNumber (property->second, value)) {
+				throw std::invalid_argument ("[" + kSection + "] " + kProperty
+					+ "=" + property->second + " is not a valid number");
+			}
+			return value;
+		}
+	}
+	throw std::invalid_argument ("[" + kSection + "] " + kProperty
+		+ " is missing");
+} // end Get Config
+
+// Get Config
+// - same as above, but a missing property returns (fallback)
+template <typename T>
+inline T GetConfig (const config_map& kConfigs,
+					const std::string& kSection,
+					const std::string& kProperty,
+					T fallback) {
+	auto section = kConfigs.find (kSection);
+	if (section == kConfigs.end ()
+		|| section->second.find (kProperty) == section->second.end ()) {
+		return fallback;
+	}
+	return GetConfig <T> (kConfigs, kSection, kProperty);
+} // end Get Config
+
+// The methods below copy every cell into a std::string, ParseCSV is faster
+// for large files.
+
 // Count Delimiter
 // - count number of delimiters within string to make creating vectors and
 // - matrices more efficient
-static double CountDelimiter (const std::string& kString,
+inline double CountDelimiter (const std::string& kString,
 							  const char kDelimiter) {
 	std::string line, item;
 	double ctr = 0;
@@ -117,7 +351,7 @@ static double CountDelimiter (const std::string& kString,
 
 // Split String
 // - split string given delimiter
-static std::vector<std::string> SplitString (const std::string& kString,
+inline std::vector<std::string> SplitString (const std::string& kString,
 											 const char& kDelimiter) {
 	std::vector<std::string> split_string;
 	std::string line, item;
@@ -135,7 +369,7 @@ static std::vector<std::string> SplitString (const std::string& kString,
 
 // File To Vector
 // - parse string for delimiter and create vector for each delimiter
-static std::vector<std::string> FileToVector (const std::string& kFilename,
+inline std::vector<std::string> FileToVector (const std::string& kFilename,
 	const char& kDelimiter) {
 	std::string whole_file = FileToString(kFilename);
 	return SplitString(whole_file, kDelimiter);
@@ -143,7 +377,7 @@ static std::vector<std::string> FileToVector (const std::string& kFilename,
 
 // File To Matrix
 // - convert file to a vector of rows and then convert to vectors of columns.
-static string_matrix FileToMatrix (const std::string &kFilename,
+inline string_matrix FileToMatrix (const std::string &kFilename,
 								   char kDelimiter,
 								   unsigned int columns) {
 	std::vector <std::string> file_vector;
@@ -1,48 +1,17 @@
 #include "include/logger.h"
-#include <iostream>
-#include <fstream>
-#include <ctime>
+#include "include/Clock.h"
 
-// the constructor starts the message with DateTime
-Logger::Logger (std::string context, std::string path) 
-	: context_(context), path_(path) {
-	msg_ =  Logger::GetDateTime () + '\t';
+// the constructor stamps the record with the time and destination, the date
+// and time strings are formatted later by the LogWriter thread
+Logger::Logger (std::string context, std::string path) {
+	record_.format = LogRecord::TEXT;
+	record_.utc_ms = Clock::Get ()->Milliseconds ();
+	record_.SetDestination (context, path);
 }  // end constructor
 
 // becuase the logger object is constructor inline, it is destroyed at the end
-// of the line which then writes the message to the log file.
+// of the line which then pushes the message to the log writer.
 Logger::~Logger () {
-	Logger::ToFile ();
+	record_.SetData (ss_.str ());
+	LogWriter::Get ().Push (record_);
 }  // end destructor
-
-// To File
-// - constructs the filename based on the date and context of the logger
-void Logger::ToFile  () {
-	std::string file_name = path_ + context_ + "_" + Logger::GetDate () 
-		+ ".log";
-	std::ofstream output_file(file_name, std::ios_base::app);
-	if (output_file.is_open()) {
-		output_file << msg_ << '\n';
-	}
-	output_file.close();
-}  // end To File
-
-// Get Date
-// - gets the local time date for the file name
-std::string Logger::GetDate () {
-    time_t now = time(0);
-    struct tm ts = *localtime(&now);
-    char buf[100];
-    strftime(buf, sizeof(buf), "%F", &ts);
-    return std::string(buf);
-} // end Get Date
-
-// Get Date Time
-// - gets the local date and time for indexing of the data
-std::string Logger::GetDateTime () {
-    time_t now = time(0);
-    struct tm ts = *localtime(&now);
-    char buf[100];
-    strftime(buf, sizeof(buf), "%F %T", &ts);
-    return std::string(buf);
-} // end Get Date Time
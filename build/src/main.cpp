@@ -32,16 +32,22 @@
 // INCLUDES
 #include <iostream>
 #include <thread>
-#include <chrono>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
 #include "include/DistributedEnergyResource.h"
+#include "include/Fleet.h"
 #include "include/CommandLineInterface.h"
 #include "include/Operator.h"
 #include "include/SmartGridDevice.h"
+#include "include/AllJoynTransport.h"
+#include "include/TelemetryPublisher.h"
+#include "include/Executor.h"
+#include "include/ControlTasks.h"
 #include "include/ServerListener.h"
 #include "include/tsu.h"
+#include "include/LogWriter.h"
 #include "include/aj_utility.h"
 
 // NAMESPACES
@@ -50,7 +56,7 @@ using namespace ajn;
 
 // GLOBALS
 bool done = false;              // signal program to stop
-extern bool scheduled;  // toggle operator using program args/CLI
+extern atomic <bool> scheduled;  // toggle operator using program args/CLI
 
 // Program Help
 // - command line interface arguments during run, [] items have default values
@@ -110,87 +116,6 @@ static std::map <std::string, std::string> ArgumentParser (int argc,
     return parameters;
 }  // end Argument Parser
 
-// THREADS
-// -------
-
-// Resource Loop
-// - this loop runs the resource control loop at the desired frequency
-// - it subtracks processing time of the Loop () function to make the frequency
-// - more consistant
-void ResourceLoop (unsigned int sleep, DistributedEnergyResource* der_ptr) {
-    unsigned int time_remaining, time_past;
-    unsigned int time_wait = sleep;
-    auto time_start = chrono::high_resolution_clock::now();
-    auto time_end = chrono::high_resolution_clock::now();
-    chrono::duration<double, milli> time_elapsed;
-
-    while (!done) {
-        time_start = chrono::high_resolution_clock::now();
-            // time since last control call;
-            time_elapsed = time_start - time_end;
-            time_past = time_elapsed.count();
-            der_ptr->Loop(time_past);
-        time_end = chrono::high_resolution_clock::now();
-        time_elapsed = time_end - time_start;
-
-        // determine sleep duration after deducting process time
-        if (time_wait - time_elapsed.count() > 0) {
-            time_remaining = time_wait - time_elapsed.count();
-            this_thread::sleep_for (chrono::milliseconds (time_remaining));
-        } 
-    }
-}  // end Resource Loop
-
-// Operator Loop
-// - this loop runs the resource control loop at the desired frequency
-// - it subtracks processing time of the Loop () function to make the frequency
-// - more consistant
-void OperatorLoop (unsigned int sleep, Operator* oper_ptr) {
-    unsigned int time_remaining;
-    unsigned int time_wait = sleep;
-    auto time_start = chrono::high_resolution_clock::now();
-    auto time_end = chrono::high_resolution_clock::now();
-    chrono::duration<double, milli> time_elapsed;
-
-    while (!done && scheduled) {
-        time_start = chrono::high_resolution_clock::now();
-        oper_ptr->Loop();
-        time_end = chrono::high_resolution_clock::now();
-        time_elapsed = time_end - time_start;
-
-        // determine sleep duration after deducting process time
-        if (time_wait - time_elapsed.count() > 0) {
-            time_remaining = time_wait - time_elapsed.count();
-            this_thread::sleep_for (chrono::milliseconds (time_remaining));
-        } 
-    }
-}  // end Resource Loop
-
-// Smart Grid Device Loop
-// - this loop runs the resource control loop at the desired frequency
-// - it subtracks processing time of the Loop () function to make the frequency
-// - more consistant
-void SmartGridDeviceLoop (unsigned int sleep, SmartGridDevice* sgd_ptr) {
-    unsigned int time_remaining;
-    unsigned int time_wait = sleep;
-    auto time_start = chrono::high_resolution_clock::now();
-    auto time_end = chrono::high_resolution_clock::now();
-    chrono::duration<double, milli> time_elapsed;
-
-    while (!done) {
-        time_start = chrono::high_resolution_clock::now();
-        sgd_ptr->Loop();
-        time_end = chrono::high_resolution_clock::now();
-        time_elapsed = time_end - time_start;
-
-        // determine sleep duration after deducting process time
-        if (time_wait - time_elapsed.count() > 0) {
-            time_remaining = time_wait - time_elapsed.count();
-            this_thread::sleep_for (chrono::milliseconds (time_remaining));
-        } 
-    }
-}  // end Resource Loop
-
 // Main
 // ----
 int main (int argc, char** argv) {
@@ -216,13 +141,37 @@ int main (int argc, char** argv) {
     DistributedEnergyResource* der_ptr 
         = new DistributedEnergyResource(configs["DER"]);
 
+    // the fleet is optional and only created when [Fleet] units is set
+    // ~ reference Fleet.h
+    Fleet* fleet_ptr = NULL;
+    if (tsu::GetConfig <unsigned int> (configs, "Fleet", "units", 0) > 0) {
+        cout << "\tCreating Fleet of " << configs["Fleet"]["units"] 
+            << " Distributed Energy Resources\n";
+        fleet_ptr = new Fleet(configs);
+    }
+
     cout << "\tCreating Operator\n";
     // ~ reference Operator.h
     Operator* oper_ptr = new Operator(configs["Operator"]["schedule"], der_ptr);
 
+    cout << "\tCreating Telemetry Publisher\n";
+    // ~ reference TelemetryPublisher.h
+    TelemetryPublisher* publisher_ptr 
+        = new TelemetryPublisher(configs["Telemetry"]);
+
+    cout << "\tCreating Executor\n";
+    // ~ reference Executor.h
+    Executor* executor_ptr = new Executor();
+    // ~ reference ControlTasks.h
+    control_tasks::WakeOnCommand(executor_ptr, der_ptr);
+
     cout << "\tCreating Command Line Interface\n";
     // ~ reference CommandLineInterface.h
-    CommandLineInterface CLI(der_ptr);
+    CommandLineInterface CLI(der_ptr, 
+                             oper_ptr, 
+                             publisher_ptr, 
+                             executor_ptr, 
+                             fleet_ptr);
 
     cout << "\tCreating AllJoyn Message Bus\n";
     try {
@@ -264,7 +213,7 @@ int main (int argc, char** argv) {
     // inform users of session related events
     // ~ AllJoyn Docs
     aj_utility::SessionPortListener SPL;
-    SessionPort port = stoul(configs["AllJoyn"]["port"]);
+    SessionPort port = tsu::GetConfig <SessionPort> (configs, "AllJoyn", "port");
 
     cout << "\tSetting up AllJoyn Bus Attachment...\n";
     // ~ reference aj_utility.cpp
@@ -281,43 +230,67 @@ int main (int argc, char** argv) {
     const char* server_name = configs["AllJoyn"]["server_interface"].c_str();
     Observer *obs_ptr = new Observer(*bus_ptr, &server_name, 1);
 
-    cout << "\tCreating AllJoyn Server Listener\n";
-    // ~ reference ServerListener.cpp
-    ServerListener *listner_ptr = new ServerListener(bus_ptr,
-                                                     obs_ptr,
-                                                     der_ptr,
-                                                     server_name);
-    obs_ptr->RegisterListener(*listner_ptr);
-
-    cout << "\tCreating AllJoyn Smart Grid Device\n";
-    // ~ reference SmartGridDevice.cpp
+    cout << "\tCreating AllJoyn Transport\n";
+    // ~ reference AllJoynTransport.cpp
     const char* device_name = configs["AllJoyn"]["device_interface"].c_str();
     string path = configs["AllJoyn"]["path"];
     string region = "region" + to_string(rand() % 100) + "/";
     string substation = "substation" + to_string(rand() % 100) + "/";
     string feeder = "feeder" + to_string(rand() % 100) + "/";
     path = path + region + substation + feeder + app;
+    AllJoynTransport *transport_ptr = new AllJoynTransport(bus_ptr,
+                                                           device_name,
+                                                           path.c_str(),
+                                                           server_name);
+
+    cout << "\tCreating Server Listener\n";
+    // ~ reference ServerListener.cpp
+    bool fake_hwclock = configs["AllJoyn"]["fake_hwclock"] != "n";
+    ServerListener *listner_ptr = new ServerListener(der_ptr,
+                                                     transport_ptr,
+                                                     fake_hwclock);
+    obs_ptr->RegisterListener(*transport_ptr);
+
+    cout << "\tCreating Smart Grid Device\n";
+    // ~ reference SmartGridDevice.cpp
     SmartGridDevice *sgd_ptr = new SmartGridDevice(der_ptr, 
-                                                   bus_ptr, 
-                                                   device_name, 
-                                                   path.c_str());
+                                                   publisher_ptr,
+                                                   transport_ptr);
 
     cout << "\t\tRegistering AllJoyn Smart Grid Device\n";
-    if (ER_OK != bus_ptr->RegisterBusObject(*sgd_ptr)){
+    if (ER_OK != bus_ptr->RegisterBusObject(*transport_ptr)){
         cout << "\t\t[ERROR]: Failed Registration!\n";
         return EXIT_FAILURE;
     }
     about_ptr->Announce(port, about_data);
 
-    // most objects will have a dedicated thread, but not all
-    cout << "\tSpawning threads...\n";
-    thread DER (ResourceLoop, stoul(configs["Threads"]["sleep"]), der_ptr);
-    thread OPER (
-    	OperatorLoop, stoul(configs["Threads"]["sleep"]), oper_ptr
-    );
-    thread SGD (
-    	SmartGridDeviceLoop, stoul(configs["Threads"]["sleep"]), sgd_ptr
-    );
+    // every control loop is a task of the executor, which runs them on one
+    // thread at the [Threads] sleep period
+    // ~ reference Executor.h
+    cout << "\tSpawning executor...\n";
+    unsigned int sleep 
+        = tsu::GetConfig <unsigned int> (configs, "Threads", "sleep");
+    unsigned int max_sleep 
+        = tsu::GetConfig <unsigned int> (configs, "Threads", "max_sleep", sleep);
+    // ~ reference ControlTasks.h
+    control_tasks::AddResource(executor_ptr, der_ptr, publisher_ptr, sleep,
+                               max_sleep);
+    if (fleet_ptr) {
+        executor_ptr->Every("fleet", sleep, [fleet_ptr] (float delta_time) {
+            fleet_ptr->Loop(delta_time);
+        });
+    }
+    // the operator task stays registered so the CLI can enable it again
+    executor_ptr->Every("operator", sleep, [oper_ptr] (float delta_time) {
+        (void)delta_time;
+        if (scheduled) {
+            oper_ptr->Loop();
+        } else {
+            oper_ptr->Pause();
+        }
+    });
+    control_tasks::AddDevice(executor_ptr, sgd_ptr, sleep);
+    thread EXEC (&Executor::Run, executor_ptr);
 
     // the CLI will control the program and can signal the program to stop
 	cout << "Initialization complete...\n";
@@ -333,15 +306,14 @@ int main (int argc, char** argv) {
     // - dont really explain the shutdown procedure for lots of alljoyn objects
 	cout << "Closing program...\n";
 
-	// First join all active threads to main thread
+	// First stop the executor and join it to the main thread
 	cout << "\tJoining threads\n";
-	DER.join ();
-	OPER.join ();
-	SGD.join ();
+	executor_ptr->Stop ();
+	EXEC.join ();
 
     cout << "\tUnregistering AllJoyn objects\n";
-    obs_ptr->UnregisterListener (*listner_ptr);
-    bus_ptr->UnregisterBusObject(*sgd_ptr);
+    obs_ptr->UnregisterListener (*transport_ptr);
+    bus_ptr->UnregisterBusObject(*transport_ptr);
     status = bus_ptr->Stop ();
     status = bus_ptr->Join ();
 
@@ -350,12 +322,19 @@ int main (int argc, char** argv) {
     cout << "\nDeleting pointers...\n";
     delete sgd_ptr;
     delete listner_ptr;
+    delete transport_ptr;
     delete obs_ptr;
     delete about_ptr;
     delete bus_ptr;
+    delete executor_ptr;
+    delete publisher_ptr;
     delete oper_ptr;
+    delete fleet_ptr;
     delete der_ptr;
 
+    cout << "\tFlushing logs\n";
+    LogWriter::Get ().Stop ();
+
     #ifdef ROUTER
         cout << "\tShutting down AllJoyn Router\n";
         status = AllJoynRouterShutdown ();
@@ -0,0 +1,32 @@
+// Description:
+//      Converts binary DER telemetry logs (log_format=binary) back to the tab
+//      separated layout of the text logs.
+//
+// Usage:
+// LogConvert <input .bin file> [<output .log file>]
+
+// INCLUDES
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "../src/include/LogWriter.h"
+
+using namespace std;
+
+int main (int argc, char** argv) {
+    if (argc < 2) {
+        cout << "\n[Usage] > " << argv[0]
+            << " <input .bin file> [<output .log file>]\n"
+            "\toutput defaults to the terminal" << endl;
+        return EXIT_FAILURE;
+    }
+
+    bool status;
+    if (argc > 2) {
+        ofstream output (argv[2]);
+        status = LogWriter::ConvertTelemetry (argv[1], output);
+    } else {
+        status = LogWriter::ConvertTelemetry (argv[1], cout);
+    }
+    return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}  // end main
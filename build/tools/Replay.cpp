@@ -0,0 +1,246 @@
+// Description:
+//      Replays the [Operator] schedule against one or more [DER] resources
+//      faster than real-time. A virtual clock is installed for the whole
+//      program and the EventScheduler moves it from one event to the next.
+//      Each resource runs the way the resource task of main does: it is
+//      stepped at control_tasks::NextStep (), at most [Threads] max_sleep ms,
+//      and right away when a schedule row queues a command. A SmartGridDevice
+//      over a LoopbackTransport sends the telemetry. The snapshot only changes
+//      when the resource steps, so the device loop runs after every step, on
+//      the hour for the heartbeat and when the publisher is next due.
+//
+//      With -u <units> every unit is a resource with its own operator and
+//      publisher. Like the fleet, a unit section [DER.<n>] overrides the [DER]
+//      properties, give each unit its own log_path to keep their logs apart.
+//
+// Usage:
+// replay -c <file path> [-s <start utc>] [-d <duration seconds>] [-u <units>]
+
+// INCLUDES
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <map>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "../src/include/Clock.h"
+#include "../src/include/ControlTasks.h"
+#include "../src/include/EventScheduler.h"
+#include "../src/include/DistributedEnergyResource.h"
+#include "../src/include/LoopbackTransport.h"
+#include "../src/include/Operator.h"
+#include "../src/include/SmartGridDevice.h"
+#include "../src/include/TelemetryPublisher.h"
+#include "../src/include/LogWriter.h"
+#include "../src/include/tsu.h"
+
+using namespace std;
+
+// one resource with its own operator and smart grid device
+struct Unit {
+    unsigned int index;
+    DistributedEnergyResource der;
+    Operator oper;
+    TelemetryPublisher publisher;
+    LoopbackTransport transport;
+    SmartGridDevice sgd;
+    unsigned long long due;         // (ms) the step that is still valid
+    unsigned long long send;        // (ms) the telemetry that is still valid
+    unsigned long long last_step;   // (ms) time of the last step
+    bool limited;
+
+    Unit (unsigned int index,
+          map <string, string> init,
+          const string& schedule,
+          map <string, string> telemetry,
+          unsigned long long now)
+        : index(index),
+          der(init),
+          oper(schedule, &der),
+          publisher(telemetry),
+          sgd(&der, &publisher, &transport),
+          due(0),
+          send(0),
+          last_step(now),
+          limited(false) {
+        publisher.Reset (der.GetSnapshot ());
+    };
+};
+
+// Program Help
+static void ProgramHelp (const string& name) {
+    cout << "\n[Usage] > " << name
+        << " -c <file path> [-s <start utc>] [-d <duration seconds>]"
+        " [-u <units>]\n"
+        "\t[] means it has a default value\n"
+        "\t -c \t configuration filename\n"
+        "\t -s \t start time, defaults to the beginning of today (utc)\n"
+        "\t -d \t duration, defaults to one day\n"
+        "\t -u \t resources, defaults to one" << endl;
+}  // end Program Help
+
+int main (int argc, char** argv) {
+    string name = argv[0];
+    map <string, string> parameters;
+    for (int i = 1; i + 1 < argc; i = i+2) {
+        parameters[argv[i]] = argv[i+1];
+    }
+    if (parameters["-c"].empty ()) {
+        ProgramHelp (name);
+        return EXIT_FAILURE;
+    }
+
+    unsigned int seconds_per_day = 60*60*24;
+    unsigned int start = Clock::Get ()->Now ();
+    start -= start % seconds_per_day;
+    unsigned int duration = seconds_per_day;
+    unsigned int units = 1;
+    try {
+        if (!parameters["-s"].empty ()) {
+            start = stoul (parameters["-s"]);
+        }
+        if (!parameters["-d"].empty ()) {
+            duration = stoul (parameters["-d"]);
+        }
+        if (!parameters["-u"].empty ()) {
+            units = stoul (parameters["-u"]);
+        }
+    } catch (...) {
+        ProgramHelp (name);
+        return EXIT_FAILURE;
+    }
+
+    // the virtual clock must be installed before any object reads the time
+    VirtualClock clock (start * 1000ULL);
+    Clock::Set (&clock);
+    EventScheduler scheduler (&clock);
+    unsigned long long end = (start + duration) * 1000ULL;
+
+    // logs are produced much faster than real-time so never drop them
+    LogWriter::Get ().SetBlocking (true);
+
+    tsu::config_map configs = tsu::MapConfigFile (parameters["-c"]);
+    unsigned int sleep
+        = tsu::GetConfig <unsigned int> (configs, "Threads", "sleep");
+    unsigned int max_sleep
+        = tsu::GetConfig <unsigned int> (configs, "Threads", "max_sleep", sleep);
+
+    // overlay the unit sections on the default section like the fleet does
+    vector <unique_ptr <Unit> > resources;
+    for (unsigned int i = 0; i < units; i++) {
+        map <string, string> init = configs["DER"];
+        auto it = configs.find ("DER." + tsu::ToString (i));
+        if (it != configs.end ()) {
+            for (const auto& property : it->second) {
+                init[property.first] = property.second;
+            }
+        }
+        resources.emplace_back (new Unit (i,
+                                          init,
+                                          configs["Operator"]["schedule"],
+                                          configs["Telemetry"],
+                                          start * 1000ULL));
+    }
+
+    // telemetry runs the device loop and waits for the publisher to be due.
+    // A newer event replaces one that is still scheduled.
+    function <void (Unit*)> telemetry = [&] (Unit* unit) {
+        unit->sgd.Loop ();
+        unsigned long long time = unit->publisher.NextDue ();
+        if (time <= clock.Milliseconds () || time >= end) {
+            return;
+        }
+        unit->send = time;
+        scheduler.At (time, [&, unit, time] () {
+            if (unit->send == time) {
+                telemetry (unit);
+            }
+        });
+    };
+
+    // resource steps at the predicted events, the same as the resource task
+    // of main. A newer step replaces one that is still scheduled.
+    unsigned int limits = 0;
+    function <void (Unit*, unsigned long long)> step_at;
+    function <void (Unit*)> step = [&] (Unit* unit) {
+        unsigned long long now = clock.Milliseconds ();
+        unit->der.Loop (now - unit->last_step);
+        unit->last_step = now;
+
+        DistributedEnergyResource& der = unit->der;
+        bool empty = der.GetImportEnergy () == 0 || der.GetExportEnergy () == 0;
+        if (empty && !unit->limited) {
+            limits++;
+            cout << clock.Now () << "\tunit " << unit->index
+                << "\tenergy limit reached\n";
+        }
+        unit->limited = empty;
+        telemetry (unit);
+
+        double next = control_tasks::NextStep (&der, &unit->publisher, sleep);
+        next = max (min (next, (double)max_sleep), 1.0);
+        step_at (unit, now + (unsigned long long)ceil (next));
+    };
+    step_at = [&] (Unit* unit, unsigned long long time) {
+        unit->due = time;
+        scheduler.At (time, [&, unit, time] () {
+            if (unit->due == time) {
+                step (unit);
+            }
+        });
+    };
+
+    // schedule rows
+    function <void (Unit*)> schedule_row = [&] (Unit* unit) {
+        unit->oper.Loop ();
+        unsigned int next = unit->oper.NextEventTime (clock.Now ());
+        scheduler.At (next * 1000ULL, [&, unit] () { schedule_row (unit); });
+    };
+
+    for (auto& resource : resources) {
+        Unit* unit = resource.get ();
+
+        // commands queued by a schedule row step the resource right away
+        unit->der.SetCommandNotify ([&, unit] () {
+            step_at (unit, clock.Milliseconds ());
+        });
+        step_at (unit, start * 1000ULL);
+
+        // the hourly heartbeat of the device
+        unsigned int hour = 60*60;
+        unsigned long long first = (start + hour - start % hour) * 1000ULL;
+        scheduler.Every (first, hour * 1000ULL, [&, unit] () {
+            telemetry (unit);
+        });
+
+        // the first call at (start) only positions the operator
+        scheduler.At (start * 1000ULL, [&, unit] () { schedule_row (unit); });
+    }
+
+    auto wall_start = chrono::steady_clock::now ();
+    scheduler.Run (end);
+    for (auto& resource : resources) {
+        resource->der.Loop (end - resource->last_step);
+    }
+    chrono::duration <double> wall = chrono::steady_clock::now () - wall_start;
+
+    cout << "\n[Replay]\n"
+        << "Simulated:\t" << duration << "\tseconds\n"
+        << "Elapsed:\t" << wall.count () << "\tseconds\n"
+        << "Speed Up:\t" << duration / wall.count () << "\tx real-time\n"
+        << "Units:\t\t" << units << "\n"
+        << "Events:\t\t" << scheduler.GetEventCount () << "\n"
+        << "Limits:\t\t" << limits << "\tenergy limit crossings\n\n";
+    for (auto& resource : resources) {
+        cout << "Unit:\t\t" << resource->index << "\n";
+        resource->der.Display ();
+        resource->publisher.Display ();
+    }
+    LogWriter::Get ().Flush ();
+    LogWriter::Get ().Display ();
+
+    Clock::Set (NULL);
+    return 0;
+}  // end main